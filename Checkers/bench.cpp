@@ -0,0 +1,270 @@
+// Микробенчмарки генератора ходов, оценки и поиска.
+// Запуск: checkers_bench [--min-time-ms N] [--nnue <файл весов>] [--search-depth N]
+// Вывод — по строке JSON на каждую пару (замер, позиция):
+// {"bench":"findAllCaptures","position":"opening","iterations":...,
+//  "ns_per_op":...,"allocs_per_op":...,"ops_per_sec":...}
+// Поиск на фиксированную глубину (один поток, таблица очищается перед
+// каждым прогоном) выводится отдельно:
+// {"bench":"searchBestMove","position":"opening","depth":...,"iterations":...,
+//  "nodes":...,"ms_per_search":...,"nodes_per_sec":...}
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "board.h"
+#include "eval.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "search.h"
+#include "tt.h"
+
+// -------------------- Подсчёт выделений памяти --------------------
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// -------------------- Набор позиций --------------------
+struct BenchPosition {
+    const char* name;
+    const char* text;
+};
+
+static const BenchPosition CORPUS[] = {
+    {"opening",       "start"},
+    {"middlegame",    "W:WH3,A6,E6,G6,F7,H7,A8,C8,E8:BB1,D1,F1,H1,E2,B3,D3,F3,H5"},
+    {"man-multi",     "W:WG4,B7,D7,F7,H7,A8,C8,E8,G8:BB1,F1,H1,A2,C2,E2,G2,D3,E4,C6"},
+    {"king-multi",    "B:WB5,F5,B7,F7,H7,A8,C8,G8:BB1,F1,H1,A2,C2,E2,G2,B3,H3,KE8"},
+    {"king-endgame",  "W:WKA8,KD7,KG2,KF5:BKB1,KH3,KD1,KA4"},
+};
+
+// Результат, который нельзя выбросить оптимизатору
+static volatile uint64_t benchSink = 0;
+
+// -------------------- Замер --------------------
+// Запускает op партиями, удваивая их, пока партия не займёт minTimeMs
+template <class Op>
+static void runBench(const char* bench, const char* position, int minTimeMs, Op op) {
+    for (int i = 0; i < 16; ++i) op(i);   // прогрев
+
+    uint64_t iterations = 64;
+    while (true) {
+        uint64_t allocsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            op(static_cast<int>(i));
+        }
+        auto end = std::chrono::steady_clock::now();
+        uint64_t allocs = allocationCount.load(std::memory_order_relaxed) - allocsBefore;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (ns >= minTimeMs * 1e6 || iterations >= (1ull << 40)) {
+            double nsPerOp = ns / static_cast<double>(iterations);
+            std::cout << std::format(
+                "{{\"bench\":\"{}\",\"position\":\"{}\",\"iterations\":{},"
+                "\"ns_per_op\":{:.2f},\"allocs_per_op\":{:.3f},\"ops_per_sec\":{:.0f}}}\n",
+                bench, position, iterations, nsPerOp,
+                static_cast<double>(allocs) / static_cast<double>(iterations),
+                1e9 / nsPerOp);
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+static void benchPosition(const BenchPosition& bp, int minTimeMs, const NnueNetwork* nnue) {
+    Position pos;
+    bool whiteTurn = true;
+    if (!parsePosition(bp.text, pos, whiteTurn)) {
+        std::cerr << "Некорректная позиция в наборе: " << bp.name << "\n";
+        std::exit(1);
+    }
+    int color = whiteTurn ? 1 : -1;
+
+    MoveList legal;
+    generateLegalMoves(pos, whiteTurn, legal);
+    if (legal.empty()) return;
+
+    // makeOneStep + unmakeStep: первый шаг первого легального хода
+    Move first = legal[0];
+    MoveStep step = pathStep(movePath(pos, first), 0);
+    bool isCapture = captureCount(first) > 0;
+    runBench("makeOneStep", bp.name, minTimeMs, [&](int) {
+        Position work = pos;
+        StepUndo undo;
+        makeOneStep(work, step, isCapture, undo);
+        unmakeStep(work, undo);
+        benchSink = benchSink + work.white;
+    });
+
+    // makeMove: ход целиком, по очереди все легальные ходы
+    runBench("makeMove", bp.name, minTimeMs, [&](int i) {
+        Position work = pos;
+        makeMove(work, legal[i % legal.size()]);
+        benchSink = benchSink + work.black;
+    });
+
+    // getAllCapturesForPiece: по очереди каждая фигура стороны хода
+    int pieces[SQUARE_COUNT];
+    int ownCount = 0;
+    for (uint32_t own = sidePieces(pos, color); own; own &= own - 1) {
+        pieces[ownCount++] = std::countr_zero(own);
+    }
+    runBench("getAllCapturesForPiece", bp.name, minTimeMs, [&](int i) {
+        int sq = pieces[i % ownCount];
+        MoveList moves;
+        getAllCapturesForPiece(pos, squareRow(sq), squareCol(sq), moves);
+        benchSink = benchSink + moves.size();
+    });
+
+    runBench("findAllCaptures", bp.name, minTimeMs, [&](int) {
+        MoveList moves;
+        findAllCaptures(pos, whiteTurn, moves);
+        benchSink = benchSink + moves.size();
+    });
+
+    runBench("findAllNormalMoves", bp.name, minTimeMs, [&](int) {
+        MoveList moves;
+        findAllNormalMoves(pos, whiteTurn, moves);
+        benchSink = benchSink + moves.size();
+    });
+
+    runBench("hasAnyMove", bp.name, minTimeMs, [&](int) {
+        benchSink = benchSink + hasAnyMove(pos, whiteTurn);
+    });
+
+    // Работа игрового цикла за полуход: генерация и подсчёт фигур
+    runBench("gameLoopScan", bp.name, minTimeMs, [&](int) {
+        MoveList moves;
+        generateLegalMoves(pos, whiteTurn, moves);
+        int whiteCount = pieceCount(pos, 1);
+        int blackCount = pieceCount(pos, -1);
+        benchSink = benchSink + moves.size() + whiteCount + blackCount;
+    });
+
+    runBench("evaluate", bp.name, minTimeMs, [&](int) {
+        benchSink = benchSink + evaluate(pos, color);
+    });
+
+    if (!nnue) return;
+    // Сеть: приращение аккумулятора за ход и оценка по готовому аккумулятору
+    NnueAccumulator acc;
+    nnue->refresh(pos, acc);
+    runBench("nnueRefresh", bp.name, minTimeMs, [&](int) {
+        NnueAccumulator work;
+        nnue->refresh(pos, work);
+        benchSink = benchSink + work.values[0][0];
+    });
+    runBench("nnueUpdate", bp.name, minTimeMs, [&](int i) {
+        NnueAccumulator child;
+        nnue->update(acc, pos, legal[i % legal.size()], child);
+        benchSink = benchSink + child.values[1][0];
+    });
+    runBench("nnueEvaluate", bp.name, minTimeMs, [&](int) {
+        benchSink = benchSink + nnue->evaluate(acc, color);
+    });
+}
+
+static constexpr size_t SEARCH_BENCH_HASH_MB = 16;
+
+// Поиск на фиксированную глубину: повторяется, пока прогоны не займут
+// minTimeMs. Узлы одного прогона одинаковы — поиск однопоточный, а таблица
+// перед каждым прогоном очищается.
+static void benchSearch(const BenchPosition& bp, int minTimeMs, int depth, const NnueNetwork* nnue) {
+    Position pos;
+    bool whiteTurn = true;
+    if (!parsePosition(bp.text, pos, whiteTurn)) {
+        std::cerr << "Некорректная позиция в наборе: " << bp.name << "\n";
+        std::exit(1);
+    }
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.nnue = nnue;
+    TranspositionTable tt(SEARCH_BENCH_HASH_MB);
+
+    uint64_t iterations = 0;
+    uint64_t nodes = 0;
+    double ns = 0;
+    while (iterations == 0 || ns < minTimeMs * 1e6) {
+        tt.clear();
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result = searchBestMove(pos, whiteTurn, limits, &tt);
+        auto end = std::chrono::steady_clock::now();
+        ns += std::chrono::duration<double, std::nano>(end - start).count();
+        nodes = result.nodes;
+        benchSink = benchSink + result.bestMove.bits;
+        ++iterations;
+    }
+
+    double nsPerSearch = ns / static_cast<double>(iterations);
+    std::cout << std::format(
+        "{{\"bench\":\"searchBestMove\",\"position\":\"{}\",\"depth\":{},\"iterations\":{},"
+        "\"nodes\":{},\"ms_per_search\":{:.3f},\"nodes_per_sec\":{:.0f}}}\n",
+        bp.name, depth, iterations, nodes, nsPerSearch / 1e6,
+        static_cast<double>(nodes) * 1e9 / nsPerSearch);
+}
+
+int main(int argc, char* argv[]) {
+    int minTimeMs = 100;
+    int searchDepth = 10;
+    std::unique_ptr<NnueNetwork> nnue;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--min-time-ms" && i + 1 < argc) {
+            minTimeMs = std::atoi(argv[++i]);
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            nnue = std::make_unique<NnueNetwork>();
+            if (!nnue->load(argv[++i])) {
+                std::cerr << "Не удалось загрузить сеть: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--search-depth" && i + 1 < argc) {
+            searchDepth = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Использование: checkers_bench [--min-time-ms N] [--nnue <файл весов>]"
+                         " [--search-depth N]\n";
+            return 1;
+        }
+    }
+    if (minTimeMs < 1) minTimeMs = 1;
+    if (searchDepth < 1) searchDepth = 1;
+
+    for (const auto& bp : CORPUS) {
+        benchPosition(bp, minTimeMs, nnue.get());
+    }
+    for (const auto& bp : CORPUS) {
+        benchSearch(bp, minTimeMs, searchDepth, nnue.get());
+    }
+    return 0;
+}
@@ -0,0 +1,332 @@
+#include "board.h"
+#include "eval.h"
+
+#include <cctype>
+#include <vector>
+
+// pieceColor: 1 = белая, -1 = чёрная, 0 = нет фигуры
+int pieceColor(const Position& pos, int r, int c) {
+    uint32_t bit = squareBit(r, c);
+    if (pos.white & bit) return 1;
+    if (pos.black & bit) return -1;
+    return 0;
+}
+
+bool isEmpty(const Position& pos, int r, int c) {
+    return (occupied(pos) & squareBit(r, c)) == 0;
+}
+
+// Является ли дамкой
+bool isKing(const Position& pos, int r, int c) {
+    return (pos.kings & squareBit(r, c)) != 0;
+}
+
+// Символ фигуры на поле (для печати)
+char pieceAt(const Position& pos, int r, int c) {
+    int color = pieceColor(pos, r, c);
+    if (color == 0) return '.';
+    bool king = isKing(pos, r, c);
+    if (color == 1) return king ? 'W' : 'w';
+    return king ? 'B' : 'b';
+}
+
+// Фигура появилась на поле sq (sign = 1) или ушла с него (sign = -1):
+// ключ и материал с таблицей полей
+static void updatePieceTerms(Position& pos, int color, bool king, int sq, int sign) {
+    int kind = pieceKind(color, king);
+    pos.key ^= ZOBRIST.piece[kind][sq];
+    pos.psq[sideIndex(color)] += sign * EVAL.pieceSquare[kind][sq];
+}
+
+// Превращение в дамку при достижении конца
+void promoteIfNeeded(Position& pos, int sq) {
+    uint32_t bit = 1u << sq;
+    if (pos.kings & bit) return;
+    int color = 0;
+    if (pos.white & bit & promotionRow(1)) color = 1;
+    if (pos.black & bit & promotionRow(-1)) color = -1;
+    if (color != 0) {
+        pos.kings |= bit;
+        pos.menCount[sideIndex(color)]--;
+        pos.kingCount[sideIndex(color)]++;
+        updatePieceTerms(pos, color, false, sq, -1);
+        updatePieceTerms(pos, color, true, sq, 1);
+    }
+}
+
+void promoteIfNeeded(Position& pos, int r, int c) {
+    promoteIfNeeded(pos, squareIndex(r, c));
+}
+
+// Пересчитать счётчики фигур, ключ и материал по битбордам (после расстановки позиции)
+void recomputeDerived(Position& pos) {
+    pos.key = 0;
+    pos.psq[0] = pos.psq[1] = 0;
+    for (int color : {1, -1}) {
+        uint32_t own = sidePieces(pos, color);
+        pos.menCount[sideIndex(color)] = static_cast<uint8_t>(std::popcount(own & ~pos.kings));
+        pos.kingCount[sideIndex(color)] = static_cast<uint8_t>(std::popcount(own & pos.kings));
+        for (uint32_t pieces = own; pieces; pieces &= pieces - 1) {
+            int sq = std::countr_zero(pieces);
+            updatePieceTerms(pos, color, (pos.kings >> sq) & 1, sq, 1);
+        }
+    }
+}
+
+// Инициализация доски
+void initBoard(Position& pos) {
+    pos = Position{};
+    // Чёрные сверху (строки 0..2)
+    for (int r = 0; r < 3; ++r) {
+        pos.black |= rowMask(r);
+    }
+    // Белые снизу (строки 5..7)
+    for (int r = 5; r < BOARD_SIZE; ++r) {
+        pos.white |= rowMask(r);
+    }
+    recomputeDerived(pos);
+}
+
+// Шаг по номерам полей: captured — поле побитой фигуры или -1
+void makeStep(Position& pos, int from, int to, int captured, StepUndo& undo) {
+    uint32_t fromBit = 1u << from;
+    uint32_t toBit = 1u << to;
+    undo = StepUndo{};
+    undo.key = pos.key;
+    undo.psq[0] = pos.psq[0];
+    undo.psq[1] = pos.psq[1];
+    undo.from = from;
+    undo.to = to;
+    undo.color = (pos.white & fromBit) ? 1 : -1;
+
+    uint32_t& own = sidePieces(pos, undo.color);
+    own = (own & ~fromBit) | toBit;
+    bool king = (pos.kings & fromBit) != 0;
+    if (king) {
+        pos.kings = (pos.kings & ~fromBit) | toBit;
+    }
+    updatePieceTerms(pos, undo.color, king, from, -1);
+    updatePieceTerms(pos, undo.color, king, to, 1);
+
+    if (captured >= 0) {
+        uint32_t bit = 1u << captured;
+        undo.capturedSq = captured;
+        undo.capturedColor = (pos.white & bit) ? 1 : -1;
+        undo.capturedKing = (pos.kings & bit) != 0;
+        int side = sideIndex(undo.capturedColor);
+        if (undo.capturedKing) pos.kingCount[side]--; else pos.menCount[side]--;
+        updatePieceTerms(pos, undo.capturedColor, undo.capturedKing, captured, -1);
+        pos.white &= ~bit;
+        pos.black &= ~bit;
+        pos.kings &= ~bit;
+    }
+    bool wasKing = (pos.kings & toBit) != 0;
+    promoteIfNeeded(pos, to);
+    undo.promoted = !wasKing && (pos.kings & toBit);
+}
+
+// Выполнить один шаг (с записью для отката)
+bool makeOneStep(Position& pos, const MoveStep& step, bool isCapture, StepUndo& undo) {
+    int from = squareIndex(step.startRow, step.startCol);
+    int to = squareIndex(step.endRow, step.endCol);
+    int captured = -1;
+
+    if (isCapture) {
+        // Первая фигура на луче между началом и концом шага
+        int d = directionIndex(step.endRow - step.startRow, step.endCol - step.startCol);
+        const int8_t* ray = DIAG.ray[from][d];
+        uint32_t occ = occupied(pos);
+        for (int i = 0; ray[i] != to; ++i) {
+            if (occ & (1u << ray[i])) {
+                captured = ray[i];
+                break;
+            }
+        }
+    }
+    makeStep(pos, from, to, captured, undo);
+    return true;
+}
+
+bool makeOneStep(Position& pos, const MoveStep& step, bool isCapture) {
+    StepUndo undo;
+    return makeOneStep(pos, step, isCapture, undo);
+}
+
+// Откатить шаг, выполненный makeOneStep
+void unmakeStep(Position& pos, const StepUndo& undo) {
+    uint32_t fromBit = 1u << undo.from;
+    uint32_t toBit = 1u << undo.to;
+    if (undo.promoted) {
+        pos.kings &= ~toBit;
+        pos.kingCount[sideIndex(undo.color)]--;
+        pos.menCount[sideIndex(undo.color)]++;
+    }
+    uint32_t& own = sidePieces(pos, undo.color);
+    own = (own & ~toBit) | fromBit;
+    if (pos.kings & toBit) {
+        pos.kings = (pos.kings & ~toBit) | fromBit;
+    }
+    if (undo.capturedSq >= 0) {
+        uint32_t bit = 1u << undo.capturedSq;
+        sidePieces(pos, undo.capturedColor) |= bit;
+        int side = sideIndex(undo.capturedColor);
+        if (undo.capturedKing) {
+            pos.kings |= bit;
+            pos.kingCount[side]++;
+        } else {
+            pos.menCount[side]++;
+        }
+    }
+    pos.key = undo.key;
+    pos.psq[0] = undo.psq[0];
+    pos.psq[1] = undo.psq[1];
+}
+
+// Выполнить ход целиком: перенос фигуры, снятие побитых, превращение
+void makeMove(Position& pos, Move m) {
+    uint32_t fromBit = 1u << moveFrom(m);
+    uint32_t toBit = 1u << moveTo(m);
+    uint32_t captured = moveCaptured(m);
+    bool white = (pos.white & fromBit) != 0;
+    uint32_t& own = white ? pos.white : pos.black;
+    uint32_t& foe = white ? pos.black : pos.white;
+    bool wasKing = (pos.kings & fromBit) != 0;
+    bool king = wasKing || movePromotes(m);
+
+    int ownSide = white ? 0 : 1;
+    int foeSide = 1 - ownSide;
+    if (king && !wasKing) {
+        pos.menCount[ownSide]--;
+        pos.kingCount[ownSide]++;
+    }
+    pos.kingCount[foeSide] -= std::popcount(captured & pos.kings);
+    pos.menCount[foeSide] -= std::popcount(captured & ~pos.kings);
+
+    int color = white ? 1 : -1;
+    updatePieceTerms(pos, color, wasKing, moveFrom(m), -1);
+    updatePieceTerms(pos, color, king, moveTo(m), 1);
+    for (uint32_t rest = captured; rest; rest &= rest - 1) {
+        int sq = std::countr_zero(rest);
+        updatePieceTerms(pos, -color, (pos.kings >> sq) & 1, sq, -1);
+    }
+
+    own = (own & ~fromBit) | toBit;
+    foe &= ~captured;
+    pos.kings &= ~(fromBit | captured);
+    if (king) pos.kings |= toBit;
+}
+
+// Преобразуем (r,c) → "A3"
+std::string cellToString(int r, int c, bool userWhite) {
+    if (!userWhite) {
+        r = 7 - r;
+        c = 7 - c;
+    }
+    char file = 'A' + c;
+    char rank = '1' + r;
+    return std::string{file, rank};
+}
+
+// Разбор строки "A3" -> (row, col)
+bool parseCell(const std::string &cell, int &row, int &col, bool userWhite) {
+    if (cell.size() != 2) return false;
+
+    char file = static_cast<char>(std::toupper(cell[0]));
+    if (file < 'A' || file > 'H') return false;
+    int cRaw = file - 'A';
+
+    char digit = cell[1];
+    if (digit < '1' || digit > '8') return false;
+    int rRaw = digit - '1';
+
+    if (userWhite) {
+        row = rRaw;
+        col = cRaw;
+    } else {
+        row = 7 - rRaw;
+        col = 7 - cRaw;
+    }
+    return onBoard(row, col);
+}
+
+// -------------------- Запись позиции --------------------
+// Формат: "<сторона>:W<поля белых>:B<поля чёрных>", сторона — W или B,
+// поля через запятую в координатах доски со стороны белых ("A6"),
+// дамка помечается буквой K: "W:WC6,KD5:BB1".
+bool parsePosition(const std::string &text, Position &pos, bool &whiteTurn) {
+    if (text.empty() || text == START_POSITION) {
+        initBoard(pos);
+        whiteTurn = true;
+        return true;
+    }
+
+    pos = Position{};
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t sep = text.find(':', start);
+        parts.push_back(text.substr(start, sep - start));
+        if (sep == std::string::npos) break;
+        start = sep + 1;
+    }
+    if (parts.empty() || parts[0].size() != 1) return false;
+
+    char side = static_cast<char>(std::toupper(parts[0][0]));
+    if (side != 'W' && side != 'B') return false;
+    whiteTurn = (side == 'W');
+
+    for (size_t i = 1; i < parts.size(); ++i) {
+        const std::string &part = parts[i];
+        if (part.empty()) return false;
+        char color = static_cast<char>(std::toupper(part[0]));
+        if (color != 'W' && color != 'B') return false;
+        uint32_t &own = (color == 'W') ? pos.white : pos.black;
+
+        size_t p = 1;
+        while (p < part.size()) {
+            size_t comma = part.find(',', p);
+            std::string cell = part.substr(p, comma - p);
+            bool king = !cell.empty() && std::toupper(cell[0]) == 'K';
+            if (king) cell.erase(cell.begin());
+
+            int r, c;
+            if (!parseCell(cell, r, c, true) || squareIndex(r, c) < 0) return false;
+            uint32_t bit = squareBit(r, c);
+            if (occupied(pos) & bit) return false;
+            own |= bit;
+            if (king) pos.kings |= bit;
+
+            if (comma == std::string::npos) break;
+            p = comma + 1;
+        }
+    }
+    recomputeDerived(pos);
+    return true;
+}
+
+std::string positionToString(const Position &pos, bool whiteTurn) {
+    std::string text(1, whiteTurn ? 'W' : 'B');
+    for (int color : {1, -1}) {
+        text += (color == 1) ? ":W" : ":B";
+        uint32_t pieces = sidePieces(pos, color);
+        bool first = true;
+        while (pieces) {
+            int sq = std::countr_zero(pieces);
+            pieces &= pieces - 1;
+            if (!first) text += ',';
+            first = false;
+            if (pos.kings & (1u << sq)) text += 'K';
+            text += cellToString(squareRow(sq), squareCol(sq), true);
+        }
+    }
+    return text;
+}
+
+// Ход в записи со стороны белых: "C6-D5", бой — "C6:E4"
+std::string moveToString(Move m) {
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    return cellToString(squareRow(from), squareCol(from), true)
+         + (moveCaptured(m) ? ":" : "-")
+         + cellToString(squareRow(to), squareCol(to), true);
+}
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <bit>
+#include <array>
+#include <string>
+
+static constexpr int BOARD_SIZE = 8;
+static constexpr int SQUARE_COUNT = 32;
+static constexpr int MAX_CAPTURES = 12;   // больше 12 фигур у соперника не бывает
+static constexpr int MAX_MOVES = 256;     // с запасом для любой позиции
+
+// -------------------- Структуры данных --------------------
+struct MoveStep {
+    int startRow, startCol;
+    int endRow, endCol;
+};
+
+// Упакованный ход (64 бита):
+//   биты 0..4   — поле начала
+//   биты 5..9   — поле окончания
+//   бит 10      — шашка становится дамкой
+//   биты 32..63 — маска побитых фигур
+// Промежуточные поля приземления не хранятся, см. movePath.
+struct Move {
+    uint64_t bits;
+
+    bool operator==(const Move&) const = default;
+};
+
+// Путь хода для вывода: стартовое поле и поля приземления
+struct MovePath {
+    int squares[MAX_CAPTURES + 1];
+    int stepsCount = 0;
+};
+
+// Список ходов фиксированной ёмкости, целиком лежит у вызывающего
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    // Переполнение — ошибка в MAX_MOVES: молча терять ходы нельзя
+    void push(Move m) {
+        assert(count < MAX_MOVES);
+        moves[count++] = m;
+    }
+    void clear() { count = 0; }
+    // Есть ли ход m среди элементов, начиная с first
+    bool contains(Move m, int first = 0) const {
+        for (int i = first; i < count; ++i) {
+            if (moves[i] == m) return true;
+        }
+        return false;
+    }
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    const Move& operator[](int i) const { return moves[i]; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Номер стороны в массивах счётчиков: 0 = белые, 1 = чёрные
+constexpr int sideIndex(int color) {
+    return (color == 1) ? 0 : 1;
+}
+
+// Позиция: битборды по 32 тёмным полям.
+// Поле (r, c) с нечётной суммой r + c имеет номер r * 4 + c / 2.
+struct Position {
+    uint32_t white = 0;
+    uint32_t black = 0;
+    uint32_t kings = 0;
+    // Число шашек и дамок каждой стороны (индекс — sideIndex).
+    // Ведётся вместе с битбордами в makeStep, makeMove и promoteIfNeeded.
+    uint8_t menCount[2] = {0, 0};
+    uint8_t kingCount[2] = {0, 0};
+    // Ключ Зобриста расстановки (без стороны хода, см. positionHash).
+    // Ведётся так же, как счётчики.
+    uint64_t key = 0;
+    // Материал с таблицей полей каждой стороны (см. eval.h), ведётся
+    // так же, как ключ
+    int16_t psq[2] = {0, 0};
+};
+
+// Маска строки r — четыре её тёмных поля
+constexpr uint32_t rowMask(int r) {
+    return 0xFu << (r * 4);
+}
+
+// Проверка валидности координат
+constexpr bool onBoard(int r, int c) {
+    return (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE);
+}
+
+// Номер тёмного поля (r, c), -1 для светлого
+constexpr int squareIndex(int r, int c) {
+    if ((r + c) % 2 == 0) return -1;
+    return r * 4 + c / 2;
+}
+
+constexpr int squareRow(int sq) {
+    return sq / 4;
+}
+
+constexpr int squareCol(int sq) {
+    int r = sq / 4;
+    return 2 * (sq % 4) + ((r % 2 == 0) ? 1 : 0);
+}
+
+// Бит поля (r, c); для светлых полей — 0
+inline uint32_t squareBit(int r, int c) {
+    int sq = squareIndex(r, c);
+    return (sq < 0) ? 0u : (1u << sq);
+}
+
+// -------------------- Диагональные таблицы --------------------
+// Направления: 0 = (+1,+1), 1 = (+1,-1), 2 = (-1,+1), 3 = (-1,-1)
+inline constexpr int DIRECTIONS[4][2] = {{1,1},{1,-1},{-1,1},{-1,-1}};
+
+// Индекс направления по знакам шага
+constexpr int directionIndex(int dr, int dc) {
+    return (dr < 0 ? 2 : 0) + (dc < 0 ? 1 : 0);
+}
+
+// Для каждого поля и направления: сосед, поле прыжка и весь луч до края
+struct DiagonalTables {
+    int8_t neighbour[SQUARE_COUNT][4];         // -1, если соседа нет
+    int8_t jump[SQUARE_COUNT][4];              // -1, если прыжок за край
+    int8_t ray[SQUARE_COUNT][4][BOARD_SIZE];   // поля по мере удаления
+    int8_t rayLength[SQUARE_COUNT][4];
+    uint32_t rayMask[SQUARE_COUNT][4];
+};
+
+constexpr DiagonalTables buildDiagonalTables() {
+    DiagonalTables t{};
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        for (int d = 0; d < 4; ++d) {
+            int r = squareRow(sq) + DIRECTIONS[d][0];
+            int c = squareCol(sq) + DIRECTIONS[d][1];
+            int len = 0;
+            while (onBoard(r, c)) {
+                int next = squareIndex(r, c);
+                t.ray[sq][d][len++] = static_cast<int8_t>(next);
+                t.rayMask[sq][d] |= 1u << next;
+                r += DIRECTIONS[d][0];
+                c += DIRECTIONS[d][1];
+            }
+            t.rayLength[sq][d] = static_cast<int8_t>(len);
+            t.neighbour[sq][d] = (len > 0) ? t.ray[sq][d][0] : -1;
+            t.jump[sq][d] = (len > 1) ? t.ray[sq][d][1] : -1;
+        }
+    }
+    return t;
+}
+
+// Считаются при компиляции, во время работы не инициализируются
+inline constexpr DiagonalTables DIAG = buildDiagonalTables();
+
+// Противоположное направление: 0 <-> 3, 1 <-> 2
+constexpr int oppositeDirection(int d) {
+    return 3 - d;
+}
+
+// -------------------- Множественные сдвиги --------------------
+// Шаг по диагонали меняет номер поля на величину, зависящую только от
+// чётности строки; два и четыре шага — уже на постоянную величину.
+// Маски оставляют только поля, у которых такой шаг не уходит за край.
+struct DiagonalShift {
+    uint32_t mask[2];    // шаг 1 из чётных / нечётных строк
+    int offset[2];
+    uint32_t mask2;      // шаг 2
+    int offset2;
+    uint32_t mask4;      // шаг 4
+    int offset4;
+};
+
+constexpr std::array<DiagonalShift, 4> buildDiagonalShifts() {
+    std::array<DiagonalShift, 4> shifts{};
+    for (int d = 0; d < 4; ++d) {
+        auto &s = shifts[d];
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            int parity = squareRow(sq) % 2;
+            if (DIAG.rayLength[sq][d] >= 1) {
+                s.mask[parity] |= 1u << sq;
+                s.offset[parity] = DIAG.ray[sq][d][0] - sq;
+            }
+            if (DIAG.rayLength[sq][d] >= 2) {
+                s.mask2 |= 1u << sq;
+                s.offset2 = DIAG.ray[sq][d][1] - sq;
+            }
+            if (DIAG.rayLength[sq][d] >= 4) {
+                s.mask4 |= 1u << sq;
+                s.offset4 = DIAG.ray[sq][d][3] - sq;
+            }
+        }
+    }
+    return shifts;
+}
+
+inline constexpr std::array<DiagonalShift, 4> SHIFTS = buildDiagonalShifts();
+
+constexpr uint32_t shiftSquares(uint32_t x, int offset) {
+    return (offset >= 0) ? (x << offset) : (x >> -offset);
+}
+
+// Все поля множества x, сдвинутые на шаг в направлении d
+constexpr uint32_t stepSquares(uint32_t x, int d) {
+    const auto &s = SHIFTS[d];
+    return shiftSquares(x & s.mask[0], s.offset[0]) | shiftSquares(x & s.mask[1], s.offset[1]);
+}
+
+// Заполнение Когге–Стоуна: gen и все поля, до которых из gen можно
+// дойти в направлении d по пустым полям (empty), не перепрыгивая фигуры
+constexpr uint32_t occludedFill(uint32_t gen, uint32_t empty, int d) {
+    const auto &s = SHIFTS[d];
+    gen |= empty & stepSquares(gen, d);
+    empty &= stepSquares(empty, d);
+    gen |= empty & shiftSquares(gen & s.mask2, s.offset2);
+    empty &= shiftSquares(empty & s.mask2, s.offset2);
+    gen |= empty & shiftSquares(gen & s.mask4, s.offset4);
+    return gen;
+}
+
+// Ближайшее к началу луча поле маски: вниз — младший бит, вверх — старший
+constexpr int nearestSquare(uint32_t mask, int d) {
+    return (d < 2) ? std::countr_zero(mask) : 31 - std::countl_zero(mask);
+}
+
+// -------------------- Ключи Зобриста --------------------
+// Перемешивание 64-битного слова (splitmix64)
+constexpr uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Вид фигуры: белая шашка, белая дамка, чёрная шашка, чёрная дамка
+constexpr int pieceKind(int color, bool king) {
+    return sideIndex(color) * 2 + (king ? 1 : 0);
+}
+
+struct ZobristTables {
+    uint64_t piece[4][SQUARE_COUNT];    // [pieceKind][поле]
+    uint64_t blackToMove;
+};
+
+constexpr ZobristTables buildZobristTables() {
+    ZobristTables z{};
+    uint64_t seed = 0x436865636B657273ull;
+    for (int kind = 0; kind < 4; ++kind) {
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            z.piece[kind][sq] = mix64(seed++);
+        }
+    }
+    z.blackToMove = mix64(seed++);
+    return z;
+}
+
+inline constexpr ZobristTables ZOBRIST = buildZobristTables();
+
+// Строка превращения для цвета: белые — строка 0, чёрные — последняя
+constexpr uint32_t promotionRow(int color) {
+    return rowMask(color == 1 ? 0 : BOARD_SIZE - 1);
+}
+
+inline Move encodeMove(int from, int to, uint32_t captured, bool promotes) {
+    return Move{static_cast<uint64_t>(from)
+                | (static_cast<uint64_t>(to) << 5)
+                | (promotes ? (1ull << 10) : 0ull)
+                | (static_cast<uint64_t>(captured) << 32)};
+}
+
+inline int moveFrom(Move m) {
+    return static_cast<int>(m.bits & 31);
+}
+
+inline int moveTo(Move m) {
+    return static_cast<int>((m.bits >> 5) & 31);
+}
+
+inline bool movePromotes(Move m) {
+    return (m.bits >> 10) & 1;
+}
+
+inline uint32_t moveCaptured(Move m) {
+    return static_cast<uint32_t>(m.bits >> 32);
+}
+
+inline int captureCount(Move m) {
+    return std::popcount(moveCaptured(m));
+}
+
+// i-й шаг пути в координатах доски
+inline MoveStep pathStep(const MovePath& path, int i) {
+    int from = path.squares[i];
+    int to = path.squares[i + 1];
+    return {squareRow(from), squareCol(from), squareRow(to), squareCol(to)};
+}
+
+inline uint32_t occupied(const Position& pos) {
+    return pos.white | pos.black;
+}
+
+// Фигуры стороны: 1 = белые, -1 = чёрные
+inline uint32_t sidePieces(const Position& pos, int color) {
+    return (color == 1) ? pos.white : pos.black;
+}
+
+inline uint32_t& sidePieces(Position& pos, int color) {
+    return (color == 1) ? pos.white : pos.black;
+}
+
+// Число фигур стороны без обхода доски
+inline int pieceCount(const Position& pos, int color) {
+    int side = sideIndex(color);
+    return pos.menCount[side] + pos.kingCount[side];
+}
+
+// pieceColor: 1 = белая, -1 = чёрная, 0 = нет фигуры
+int pieceColor(const Position& pos, int r, int c);
+bool isEmpty(const Position& pos, int r, int c);
+// Является ли дамкой
+bool isKing(const Position& pos, int r, int c);
+// Символ фигуры на поле (для печати)
+char pieceAt(const Position& pos, int r, int c);
+
+// Превращение в дамку при достижении конца
+void promoteIfNeeded(Position& pos, int sq);
+void promoteIfNeeded(Position& pos, int r, int c);
+
+// Пересчитать счётчики фигур, ключ и материал по битбордам (после расстановки позиции)
+void recomputeDerived(Position& pos);
+
+// Инициализация доски
+void initBoard(Position& pos);
+
+// Запись для отката одного шага
+struct StepUndo {
+    uint64_t key = 0;           // ключ позиции до шага
+    int16_t psq[2] = {0, 0};    // материал с таблицей полей до шага
+    int from = -1, to = -1;     // поля хода
+    int color = 0;              // цвет походившей фигуры
+    int capturedSq = -1;        // поле побитой фигуры (-1 — без взятия)
+    int capturedColor = 0;
+    bool capturedKing = false;
+    bool promoted = false;      // шашка стала дамкой на этом шаге
+};
+
+// Шаг по номерам полей: captured — поле побитой фигуры или -1
+void makeStep(Position& pos, int from, int to, int captured, StepUndo& undo);
+// Выполнить один шаг (с записью для отката)
+bool makeOneStep(Position& pos, const MoveStep& step, bool isCapture, StepUndo& undo);
+bool makeOneStep(Position& pos, const MoveStep& step, bool isCapture);
+// Откатить шаг, выполненный makeOneStep
+void unmakeStep(Position& pos, const StepUndo& undo);
+// Выполнить ход целиком: перенос фигуры, снятие побитых, превращение
+void makeMove(Position& pos, Move m);
+
+// Преобразуем (r,c) → "A3"
+std::string cellToString(int r, int c, bool userWhite);
+// Разбор строки "A3" -> (row, col)
+bool parseCell(const std::string &cell, int &row, int &col, bool userWhite);
+
+// Запись позиции: "<сторона>:W<поля белых>:B<поля чёрных>", см. parsePosition
+inline constexpr const char* START_POSITION = "start";
+bool parsePosition(const std::string &text, Position &pos, bool &whiteTurn);
+std::string positionToString(const Position &pos, bool whiteTurn);
+// Ход в записи со стороны белых: "C6-D5", бой — "C6:E4"
+std::string moveToString(Move m);
+
+// Ключ позиции вместе со стороной хода, O(1)
+inline uint64_t positionHash(const Position &pos, bool whiteTurn) {
+    return whiteTurn ? pos.key : (pos.key ^ ZOBRIST.blackToMove);
+}
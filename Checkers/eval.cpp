@@ -0,0 +1,55 @@
+#include "eval.h"
+
+#include <bit>
+
+// Шашка на своей последней линии, пока у соперника есть шашки
+static constexpr int BACK_RANK_GUARD = 6;
+// Центральное поле под боем своей фигуры
+static constexpr int CENTRE_CONTROL = 3;
+// Поле, куда возможен тихий ход
+static constexpr int MOBILITY = 2;
+
+// Четыре центральных поля: строки 3..4, вертикали C..F
+static constexpr uint32_t CENTRE_SQUARES = 0x00066000u;
+
+// Нелинейные члены со стороны color
+static int structure(const Position& pos, int color) {
+    uint32_t own = sidePieces(pos, color);
+    uint32_t men = own & ~pos.kings;
+    uint32_t kings = own & pos.kings;
+    uint32_t empty = ~occupied(pos);
+    int firstDir = (color == 1) ? 2 : 0;   // белые идут к строке 0
+
+    int score = 0;
+
+    // Охрана последней линии: не даёт соперникам пройти в дамки
+    if (pos.menCount[sideIndex(-color)] > 0) {
+        score += BACK_RANK_GUARD * std::popcount(men & promotionRow(-color));
+    }
+
+    // Контроль центра и подвижность — множественными сдвигами
+    uint32_t attacked = 0;
+    int mobility = 0;
+    for (int d = firstDir; d < firstDir + 2; ++d) {
+        uint32_t steps = stepSquares(men, d);
+        attacked |= steps;
+        mobility += std::popcount(steps & empty);
+    }
+    if (kings) {
+        for (int d = 0; d < 4; ++d) {
+            uint32_t reach = occludedFill(kings, empty, d) & ~kings;
+            attacked |= reach | stepSquares(reach | kings, d);
+            mobility += std::popcount(reach);
+        }
+    }
+    score += CENTRE_CONTROL * std::popcount(attacked & CENTRE_SQUARES);
+    score += MOBILITY * mobility;
+    return score;
+}
+
+// Оценка позиции со стороны color (1 = белые, -1 = чёрные)
+int evaluate(const Position& pos, int color) {
+    int own = sideIndex(color);
+    int foe = 1 - own;
+    return pos.psq[own] - pos.psq[foe] + structure(pos, color) - structure(pos, -color);
+}
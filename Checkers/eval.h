@@ -0,0 +1,52 @@
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+
+// -------------------- Оценка позиции --------------------
+// Линейная часть — материал и таблица полей — ведётся в Position::psq
+// вместе с ключом при каждом шаге и ходе. В листе досчитываются только
+// нелинейные члены: охрана последней линии, контроль центра, подвижность.
+
+// Стоимость фигур
+inline constexpr int MAN_VALUE = 100;
+inline constexpr int KING_VALUE = 300;
+
+// Материал вместе с таблицей полей: [pieceKind][поле]
+struct EvalTables {
+    int16_t pieceSquare[4][SQUARE_COUNT];
+};
+
+constexpr EvalTables buildEvalTables() {
+    // Шашка: продвижение (по числу пройденных строк) и центральные вертикали
+    constexpr int ADVANCE[BOARD_SIZE] = {0, 2, 4, 7, 10, 14, 19, 0};
+    constexpr int MAN_CENTRE = 3;
+    // Дамка: большая дорога и центр
+    constexpr int KING_LONG_DIAGONAL = 10;
+    constexpr int KING_CENTRE = 5;
+
+    EvalTables t{};
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        // Таблицы записаны для белых (идут к строке 0); чёрным — поворот доски
+        int r = squareRow(sq);
+        int c = squareCol(sq);
+        bool centreCol = c >= 2 && c <= 5;
+        bool centreRow = r >= 2 && r <= 5;
+
+        int man = MAN_VALUE + ADVANCE[BOARD_SIZE - 1 - r] + (centreCol ? MAN_CENTRE : 0);
+        int king = KING_VALUE + (r + c == BOARD_SIZE - 1 ? KING_LONG_DIAGONAL : 0)
+                 + (centreCol && centreRow ? KING_CENTRE : 0);
+
+        t.pieceSquare[pieceKind(1, false)][sq] = static_cast<int16_t>(man);
+        t.pieceSquare[pieceKind(1, true)][sq] = static_cast<int16_t>(king);
+        t.pieceSquare[pieceKind(-1, false)][SQUARE_COUNT - 1 - sq] = static_cast<int16_t>(man);
+        t.pieceSquare[pieceKind(-1, true)][SQUARE_COUNT - 1 - sq] = static_cast<int16_t>(king);
+    }
+    return t;
+}
+
+inline constexpr EvalTables EVAL = buildEvalTables();
+
+// Оценка позиции со стороны color (1 = белые, -1 = чёрные)
+int evaluate(const Position& pos, int color);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// -------------------- Общие хэш-таблицы --------------------
+// Слот без блокировок для таблиц, общих для всех потоков (кэш perft,
+// таблица транспозиций). Запись — два слова: data и check = key ^ data.
+// Разорванная одновременной записью пара не пройдёт проверку ключа
+// и просто не найдётся. data == 0 — слот пуст.
+struct LocklessSlot {
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+
+    // Данные записи позиции key; false — слот пуст или занят другой позицией
+    bool load(uint64_t key, uint64_t &out) const {
+        uint64_t d = data.load(std::memory_order_relaxed);
+        uint64_t c = check.load(std::memory_order_relaxed);
+        if (d == 0 || (c ^ d) != key) return false;
+        out = d;
+        return true;
+    }
+
+    void store(uint64_t key, uint64_t d) {
+        data.store(d, std::memory_order_relaxed);
+        check.store(key ^ d, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        check.store(0, std::memory_order_relaxed);
+        data.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Число элементов таблицы: наибольшая степень двойки, которая умещается
+// в megabytes (минимум один элемент). Индекс — key & (count - 1).
+inline size_t hashTableCount(size_t megabytes, size_t elementSize) {
+    size_t count = 1;
+    while (count * 2 * elementSize <= megabytes * 1024 * 1024) count *= 2;
+    return count;
+}
@@ -1,77 +1,27 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <stdexcept>
 #include <limits>
 #include <cstdlib>
-#include <ctime>
 #include <cctype>
-#include <thread>
-#include <future>
 #include <chrono>
-
-static constexpr int BOARD_SIZE = 8;
-
-// -------------------- Структуры данных --------------------
-struct MoveStep {
-    int startRow, startCol;
-    int endRow, endCol;
-};
-
-struct MoveSequence {
-    std::vector<MoveStep> steps;
-    int capturesCount = 0;
-};
-
-// Проверка валидности координат
-bool onBoard(int r, int c) {
-    return (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE);
-}
-
-// pieceColor: 1 = белая, -1 = чёрная, 0 = нет фигуры
-int pieceColor(char p) {
-    if (p == 'w' || p == 'W') return 1;
-    if (p == 'b' || p == 'B') return -1;
-    return 0;
-}
-
-// Является ли дамкой
-bool isKing(char p) {
-    return (p == 'W' || p == 'B');
-}
-
-// Превращение в дамку при достижении конца
-void promoteIfNeeded(std::vector<std::vector<char>>& board, int r, int c) {
-    char &pc = board[r][c];
-    if (pc == 'w' && r == 0) {
-        pc = 'W';
-    } else if (pc == 'b' && r == BOARD_SIZE - 1) {
-        pc = 'B';
-    }
-}
-
-// Инициализация доски
-void initBoard(std::vector<std::vector<char>>& board) {
-    board.assign(BOARD_SIZE, std::vector<char>(BOARD_SIZE, '.'));
-    // Чёрные сверху (строки 0..2)
-    for (int r = 0; r < 3; ++r) {
-        for (int c = 0; c < BOARD_SIZE; ++c) {
-            if ((r + c) % 2 == 1) {
-                board[r][c] = 'b';
-            }
-        }
-    }
-    // Белые снизу (строки 5..7)
-    for (int r = 5; r < BOARD_SIZE; ++r) {
-        for (int c = 0; c < BOARD_SIZE; ++c) {
-            if ((r + c) % 2 == 1) {
-                board[r][c] = 'w';
-            }
-        }
-    }
-}
+#include <format>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "board.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "perft.h"
+#include "search.h"
+#include "tablebase.h"
+#include "tt.h"
 
 // Печать доски (с учётом стороны пользователя)
-void printBoard(const std::vector<std::vector<char>>& board, bool userIsWhite) {
+void printBoard(const Position& pos, bool userIsWhite) {
     std::cout << "   | A B C D E F G H\n";
     std::cout << "   -----------------\n";
 
@@ -79,7 +29,7 @@ void printBoard(const std::vector<std::vector<char>>& board, bool userIsWhite) {
         for (int r = 0; r < BOARD_SIZE; ++r) {
             std::cout << std::format(" {:2d} | ", r + 1);
             for (int c = 0; c < BOARD_SIZE; ++c) {
-                std::cout << board[r][c];
+                std::cout << pieceAt(pos, r, c);
                 if (c < BOARD_SIZE - 1) std::cout << " ";
             }
             std::cout << "\n";
@@ -89,7 +39,7 @@ void printBoard(const std::vector<std::vector<char>>& board, bool userIsWhite) {
         for (int r = BOARD_SIZE - 1; r >= 0; --r) {
             std::cout << std::format(" {:2d} | ", BOARD_SIZE - r);
             for (int c = BOARD_SIZE - 1; c >= 0; --c) {
-                std::cout << board[r][c];
+                std::cout << pieceAt(pos, r, c);
                 if (c > 0) std::cout << " ";
             }
             std::cout << "\n";
@@ -98,336 +48,10 @@ void printBoard(const std::vector<std::vector<char>>& board, bool userIsWhite) {
     std::cout << std::endl;
 }
 
-// Выполнить один шаг
-bool makeOneStep(std::vector<std::vector<char>>& board, const MoveStep& step, bool isCapture) {
-    char piece = board[step.startRow][step.startCol];
-    board[step.startRow][step.startCol] = '.';
-    board[step.endRow][step.endCol] = piece;
-
-    if (isCapture) {
-        int dirR = (step.endRow - step.startRow) > 0 ? 1 : -1;
-        int dirC = (step.endCol - step.startCol) > 0 ? 1 : -1;
-
-        int checkR = step.startRow + dirR;
-        int checkC = step.startCol + dirC;
-        while (checkR != step.endRow || checkC != step.endCol) {
-            if (pieceColor(board[checkR][checkC]) != 0) {
-                board[checkR][checkC] = '.';
-                break;
-            }
-            checkR += dirR;
-            checkC += dirC;
-        }
-    }
-    promoteIfNeeded(board, step.endRow, step.endCol);
-    return true;
-}
-
-// Выполнить всю последовательность (возможно, с множественным боем)
-bool makeMoveSequence(std::vector<std::vector<char>>& board, const MoveSequence& seq) {
-    if (seq.steps.empty()) return false;
-    bool capture = (seq.capturesCount > 0);
-    for (auto &st : seq.steps) {
-        makeOneStep(board, st, capture);
-    }
-    return true;
-}
-
-// Обычные ходы для простой шашки
-std::vector<MoveSequence> getManSimpleMoves(const std::vector<std::vector<char>>& board,
-                                            int r, int c, int color)
-{
-    std::vector<MoveSequence> result;
-    int dr = (color == 1) ? -1 : 1;
-    for (int dc : {-1, 1}) {
-        int nr = r + dr;
-        int nc = c + dc;
-        if (onBoard(nr, nc) && board[nr][nc] == '.') {
-            MoveSequence seq;
-            seq.steps.push_back({r, c, nr, nc});
-            seq.capturesCount = 0;
-            result.push_back(seq);
-        }
-    }
-    return result;
-}
-
-// Обычные ходы для дамки
-std::vector<MoveSequence> getKingSimpleMoves(const std::vector<std::vector<char>>& board,
-                                             int r, int c)
-{
-    std::vector<MoveSequence> result;
-    std::vector<std::pair<int,int>> directions = {{1,1},{1,-1},{-1,1},{-1,-1}};
-    for (auto [dr,dc] : directions) {
-        int nr = r + dr;
-        int nc = c + dc;
-        while (onBoard(nr, nc) && board[nr][nc] == '.') {
-            MoveSequence seq;
-            seq.steps.push_back({r, c, nr, nc});
-            seq.capturesCount = 0;
-            result.push_back(seq);
-
-            nr += dr;
-            nc += dc;
-        }
-    }
-    return result;
-}
-
-// Рекурсивный поиск боёв
-void searchCaptures(std::vector<std::vector<char>> board,
-                    int r, int c,
-                    int color,
-                    std::vector<std::pair<int,int>> used,
-                    MoveSequence currentSeq,
-                    std::vector<MoveSequence> &allSeq)
-{
-    bool man = !isKing(board[r][c]);
-    auto wasUsed = [&](int rr, int cc){
-        for (auto &[ur,uc] : used) {
-            if (ur == rr && uc == cc) return true;
-        }
-        return false;
-    };
-
-    std::vector<std::pair<int,int>> directions = {{1,1},{1,-1},{-1,1},{-1,-1}};
-    bool foundFurther = false;
-
-    if (man) {
-        // Простая: ±2
-        for (auto &[dr,dc] : directions) {
-            int midR = r + dr;
-            int midC = c + dc;
-            int landR = r + 2*dr;
-            int landC = c + 2*dc;
-            if (onBoard(midR, midC) && onBoard(landR, landC)) {
-                if (pieceColor(board[midR][midC]) == -color && !wasUsed(midR, midC)) {
-                    if (board[landR][landC] == '.') {
-                        auto copyB = board;
-                        MoveStep st{r,c, landR, landC};
-                        makeOneStep(copyB, st, true);
-
-                        auto used2 = used;
-                        used2.push_back({midR, midC});
-
-                        auto newSeq = currentSeq;
-                        newSeq.steps.push_back(st);
-                        newSeq.capturesCount++;
-
-                        searchCaptures(copyB, landR, landC, color, used2, newSeq, allSeq);
-                        foundFurther = true;
-                    }
-                }
-            }
-        }
-    } else {
-        // Дамка (дальний бой)
-        for (auto &[dr,dc] : directions) {
-            int stepR = r + dr;
-            int stepC = c + dc;
-            bool foeFound = false;
-            int foeR=-1, foeC=-1;
-
-            while (onBoard(stepR, stepC)) {
-                if (!foeFound) {
-                    if (board[stepR][stepC] == '.') {
-                        stepR += dr;
-                        stepC += dc;
-                    } else {
-                        if (pieceColor(board[stepR][stepC]) == -color && !wasUsed(stepR, stepC)) {
-                            foeFound = true;
-                            foeR = stepR;
-                            foeC = stepC;
-                            stepR += dr;
-                            stepC += dc;
-                        } else {
-                            break;
-                        }
-                    }
-                } else {
-                    if (board[stepR][stepC] == '.') {
-                        auto copyB = board;
-                        MoveStep st{r,c, stepR, stepC};
-                        makeOneStep(copyB, st, true);
-
-                        auto used2 = used;
-                        used2.push_back({foeR, foeC});
-
-                        auto newSeq = currentSeq;
-                        newSeq.steps.push_back(st);
-                        newSeq.capturesCount++;
-
-                        searchCaptures(copyB, stepR, stepC, color, used2, newSeq, allSeq);
-                        foundFurther = true;
-
-                        stepR += dr;
-                        stepC += dc;
-                    } else {
-                        break;
-                    }
-                }
-            }
-        }
-    }
-
-    if (!foundFurther && currentSeq.capturesCount > 0) {
-        allSeq.push_back(currentSeq);
-    }
-}
-
-// Все боевые ходы для фигуры
-std::vector<MoveSequence> getAllCapturesForPiece(const std::vector<std::vector<char>>& board,
-                                                 int rr, int cc)
-{
-    std::vector<MoveSequence> result;
-    if (pieceColor(board[rr][cc]) == 0) return result;
-
-    MoveSequence initSeq;
-    initSeq.capturesCount = 0;
-    std::vector<std::pair<int,int>> used;
-
-    searchCaptures(board, rr, cc, pieceColor(board[rr][cc]), used, initSeq, result);
-    return result;
-}
-
-// ПАРАЛЛЕЛЬНЫЙ поиск боёв
-std::vector<MoveSequence> findAllCaptures(const std::vector<std::vector<char>>& board,
-                                          bool whiteTurn)
-{
-    std::vector<MoveSequence> finalMoves;
-    int color = (whiteTurn ? 1 : -1);
-
-    unsigned int hw = std::thread::hardware_concurrency();
-    if (hw == 0) hw = 2;
-
-    int chunkSize = BOARD_SIZE / hw;
-    if (chunkSize < 1) chunkSize = 1;
-
-    std::vector<std::future<std::vector<MoveSequence>>> futures;
-    futures.reserve(hw);
-
-    for (int rowSt = 0; rowSt < BOARD_SIZE; rowSt += chunkSize) {
-        int rowEnd = std::min(rowSt + chunkSize, BOARD_SIZE);
-
-        futures.push_back(std::async(std::launch::async,
-            [rowSt,rowEnd,color,&board]() {
-                std::vector<MoveSequence> localRes;
-                for (int rr = rowSt; rr < rowEnd; ++rr) {
-                    for (int cc = 0; cc < BOARD_SIZE; ++cc) {
-                        if (pieceColor(board[rr][cc]) == color) {
-                            auto caps = getAllCapturesForPiece(board, rr, cc);
-                            localRes.insert(localRes.end(), caps.begin(), caps.end());
-                        }
-                    }
-                }
-                return localRes;
-            }
-        ));
-    }
-
-    for (auto &fut : futures) {
-        auto partial = fut.get();
-        finalMoves.insert(finalMoves.end(), partial.begin(), partial.end());
-    }
-    return finalMoves;
-}
-
-// ПАРАЛЛЕЛЬНЫЙ поиск обычных ходов
-std::vector<MoveSequence> findAllNormalMoves(const std::vector<std::vector<char>>& board,
-                                             bool whiteTurn)
-{
-    std::vector<MoveSequence> finalMoves;
-    int color = (whiteTurn ? 1 : -1);
-
-    unsigned int hw = std::thread::hardware_concurrency();
-    if (hw == 0) hw = 2;
-
-    int chunkSize = BOARD_SIZE / hw;
-    if (chunkSize < 1) chunkSize = 1;
-
-    std::vector<std::future<std::vector<MoveSequence>>> futures;
-    futures.reserve(hw);
-
-    for (int rowSt = 0; rowSt < BOARD_SIZE; rowSt += chunkSize) {
-        int rowEnd = std::min(rowSt + chunkSize, BOARD_SIZE);
-
-        futures.push_back(std::async(std::launch::async,
-            [rowSt,rowEnd,color,&board]() {
-                std::vector<MoveSequence> local;
-                for (int rr = rowSt; rr < rowEnd; ++rr) {
-                    for (int cc = 0; cc < BOARD_SIZE; ++cc) {
-                        if (pieceColor(board[rr][cc]) == color) {
-                            if (!isKing(board[rr][cc])) {
-                                auto manMoves = getManSimpleMoves(board, rr, cc, color);
-                                local.insert(local.end(), manMoves.begin(), manMoves.end());
-                            } else {
-                                auto kingMoves = getKingSimpleMoves(board, rr, cc);
-                                local.insert(local.end(), kingMoves.begin(), kingMoves.end());
-                            }
-                        }
-                    }
-                }
-                return local;
-            }
-        ));
-    }
-
-    for (auto &fut : futures) {
-        auto partial = fut.get();
-        finalMoves.insert(finalMoves.end(), partial.begin(), partial.end());
-    }
-    return finalMoves;
-}
-
-// Проверка, есть ли вообще ход
-bool hasAnyMove(const std::vector<std::vector<char>>& board, bool whiteTurn) {
-    auto captures = findAllCaptures(board, whiteTurn);
-    if (!captures.empty()) return true;
-
-    auto normals = findAllNormalMoves(board, whiteTurn);
-    return !normals.empty();
-}
-
-// Выбор случайного хода компьютером
-MoveSequence chooseComputerMove(const std::vector<MoveSequence>& moves) {
-    if (moves.empty()) {
-        return MoveSequence{};
-    }
-    int idx = std::rand() % moves.size();
-    return moves[idx];
-}
-
-// Преобразуем (r,c) → "A3"
-std::string cellToString(int r, int c, bool userWhite) {
-    if (!userWhite) {
-        r = 7 - r;
-        c = 7 - c;
-    }
-    char file = 'A' + c;
-    char rank = '1' + r;
-    return std::string{file, rank};
-}
-
-// Разбор строки "A3" -> (row, col)
-bool parseCell(const std::string &cell, int &row, int &col, bool userWhite) {
-    if (cell.size() != 2) return false;
-
-    char file = static_cast<char>(std::toupper(cell[0]));
-    if (file < 'A' || file > 'H') return false;
-    int cRaw = file - 'A';
-
-    char digit = cell[1];
-    if (digit < '1' || digit > '8') return false;
-    int rRaw = digit - '1';
-
-    if (userWhite) {
-        row = rRaw;
-        col = cRaw;
-    } else {
-        row = 7 - rRaw;
-        col = 7 - cRaw;
-    }
-    return onBoard(row, col);
+// Выбор хода компьютером: поиск с заданными ограничениями
+Move chooseComputerMove(const Position& pos, bool whiteTurn, const SearchLimits& limits,
+                        TranspositionTable* tt) {
+    return searchBestMove(pos, whiteTurn, limits, tt).bestMove;
 }
 
 // Считываем ввод человека
@@ -462,8 +86,8 @@ bool getMoveInput(int &fromR, int &fromC, int &toR, int &toC, bool userWhite) {
 }
 
 // Ход человека по координатам
-bool humanMoveByCoords(std::vector<std::vector<char>> &board,
-                       const std::vector<MoveSequence> &moves,
+bool humanMoveByCoords(Position &pos,
+                       const MoveList &moves,
                        bool userWhite)
 {
     while (true) {
@@ -474,17 +98,13 @@ bool humanMoveByCoords(std::vector<std::vector<char>> &board,
             continue;
         }
         bool found = false;
-        for (auto &sq : moves) {
-            if (!sq.steps.empty()) {
-                auto &fst = sq.steps.front();
-                auto &lst = sq.steps.back();
-                if (fst.startRow == fromR && fst.startCol == fromC
-                    && lst.endRow == toR && lst.endCol == toC)
-                {
-                    makeMoveSequence(board, sq);
-                    found = true;
-                    break;
-                }
+        for (Move m : moves) {
+            if (moveFrom(m) == squareIndex(fromR, fromC)
+                && moveTo(m) == squareIndex(toR, toC))
+            {
+                makeMove(pos, m);
+                found = true;
+                break;
             }
         }
         if (found) {
@@ -494,10 +114,254 @@ bool humanMoveByCoords(std::vector<std::vector<char>> &board,
     }
 }
 
+// Неотрицательное целое из аргумента командной строки, -1 при ошибке
+static long long parseCount(const std::string &text) {
+    try {
+        size_t used = 0;
+        long long value = std::stoll(text, &used);
+        return (used == text.size() && value >= 0) ? value : -1;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+static constexpr size_t DEFAULT_PERFT_HASH_MB = 64;
+// Больше 1 ТБ под кэш или таблицу не просим: размер в байтах должен помещаться в size_t
+static constexpr long long MAX_HASH_MB = 1 << 20;
+
+// Checkers perft <depth> [position] [--hash <MB>]
+int perftCommand(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    size_t hashMb = DEFAULT_PERFT_HASH_MB;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--hash" && i + 1 < argc) {
+            long long mb = parseCount(argv[++i]);
+            if (mb < 0 || mb > MAX_HASH_MB) {
+                std::cerr << "Некорректный размер кэша: " << argv[i] << "\n";
+                return 1;
+            }
+            hashMb = static_cast<size_t>(mb);
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.empty()) {
+        std::cerr << "Использование: Checkers perft <глубина> [позиция] [--hash <MB>]\n";
+        return 1;
+    }
+    long long depth = parseCount(args[0]);
+    if (depth < 0 || depth > 64) {
+        std::cerr << "Некорректная глубина: " << args[0] << "\n";
+        return 1;
+    }
+
+    Position pos;
+    bool whiteTurn = true;
+    std::string text = (args.size() >= 2) ? args[1] : START_POSITION;
+    if (!parsePosition(text, pos, whiteTurn)) {
+        std::cerr << "Некорректная позиция: " << text << "\n";
+        return 1;
+    }
+    try {
+        return runPerft(pos, whiteTurn, static_cast<int>(depth), hashMb);
+    } catch (const std::bad_alloc&) {
+        std::cerr << std::format("Не хватило памяти на кэш в {} MB\n", hashMb);
+        return 1;
+    }
+}
+
+static constexpr size_t DEFAULT_SEARCH_HASH_MB = 64;
+
+// Настройки поиска компьютера из командной строки.
+// По умолчанию поиск занимает все ядра.
+struct SearchOptions {
+    SearchLimits limits;
+    size_t hashMb = DEFAULT_SEARCH_HASH_MB;
+    std::unique_ptr<NnueNetwork> nnue;      // --nnue: оценка сетью
+    std::string nnuePath;
+
+    SearchOptions() {
+        limits.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+};
+
+// Разбор настроек поиска: --depth <N>, --nodes <N>, --time <ms>, --hash <MB>,
+// --threads <N>, --parallel lazy|ybwc, --nnue <файл весов>.
+// --time — жёсткий предел на ход, мягкий берётся вдвое меньше; без --depth
+// глубина тогда ограничена только временем. Остальные аргументы начиная
+// с first складываются в rest. false — ошибка в опции.
+static bool parseSearchOptions(int argc, char* argv[], int first,
+                               SearchOptions &options, std::vector<std::string> &rest)
+{
+    SearchLimits &limits = options.limits;
+    bool depthSet = false;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--parallel" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "lazy") {
+                limits.parallel = ParallelMode::LazySmp;
+            } else if (mode == "ybwc") {
+                limits.parallel = ParallelMode::Ybwc;
+            } else {
+                std::cerr << "Некорректный режим --parallel: " << mode << " (lazy или ybwc)\n";
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--nnue" && i + 1 < argc) {
+            options.nnuePath = argv[++i];
+            options.nnue = std::make_unique<NnueNetwork>();
+            if (!options.nnue->load(options.nnuePath)) {
+                std::cerr << "Не удалось загрузить сеть: " << options.nnuePath << "\n";
+                return false;
+            }
+            limits.nnue = options.nnue.get();
+            continue;
+        }
+        if ((arg == "--depth" || arg == "--nodes" || arg == "--time" || arg == "--hash"
+             || arg == "--threads") && i + 1 < argc) {
+            long long value = parseCount(argv[++i]);
+            if (value < 0 || (arg == "--depth" && (value < 1 || value >= MAX_PLY))
+                || (arg == "--threads" && (value < 1 || value > 1024))
+                || (arg == "--hash" && value > MAX_HASH_MB)) {
+                std::cerr << "Некорректное значение " << arg << ": " << argv[i] << "\n";
+                return false;
+            }
+            if (arg == "--depth") {
+                limits.depth = static_cast<int>(value);
+                depthSet = true;
+            } else if (arg == "--nodes") {
+                limits.nodes = static_cast<uint64_t>(value);
+            } else if (arg == "--time") {
+                limits.hardTimeMs = value;
+                limits.softTimeMs = value / 2;
+            } else if (arg == "--threads") {
+                limits.threads = static_cast<int>(value);
+            } else {
+                options.hashMb = static_cast<size_t>(value);
+            }
+        } else {
+            rest.push_back(arg);
+        }
+    }
+    if (limits.hardTimeMs > 0 && !depthSet) limits.depth = MAX_PLY - 1;
+    return true;
+}
+
+// Таблица транспозиций на hashMb мегабайт; nullptr — не хватило памяти
+static std::unique_ptr<TranspositionTable> makeTable(size_t hashMb) {
+    try {
+        return std::make_unique<TranspositionTable>(hashMb);
+    } catch (const std::bad_alloc&) {
+        std::cerr << std::format("Не хватило памяти на таблицу в {} MB\n", hashMb);
+        return nullptr;
+    }
+}
+
+// Checkers search [position] [--depth <N>] [--nodes <N>] [--time <ms>] [--hash <MB>]
+//                 [--threads <N>] [--parallel lazy|ybwc] [--nnue <файл>]
+int searchCommand(int argc, char* argv[]) {
+    SearchOptions options;
+    std::vector<std::string> args;
+    if (!parseSearchOptions(argc, argv, 2, options, args)) return 1;
+
+    Position pos;
+    bool whiteTurn = true;
+    std::string text = args.empty() ? START_POSITION : args[0];
+    if (!parsePosition(text, pos, whiteTurn)) {
+        std::cerr << "Некорректная позиция: " << text << "\n";
+        return 1;
+    }
+
+    auto tt = makeTable(options.hashMb);
+    if (!tt) return 1;
+    auto startTime = std::chrono::steady_clock::now();
+    SearchResult result = searchBestMove(pos, whiteTurn, options.limits,
+                                         options.hashMb ? tt.get() : nullptr);
+    auto endTime = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+
+    std::cout << std::format("Позиция: {}\n", positionToString(pos, whiteTurn));
+    if (result.bestMove == Move{}) {
+        std::cout << "Ходов нет\n";
+        return 0;
+    }
+    std::cout << std::format("Лучший ход: {}\n", moveToString(result.bestMove));
+    std::cout << std::format("Оценка: {}\n", result.score);
+    std::cout << std::format("Глубина: {}\n", result.depth);
+    std::cout << std::format("Узлов: {}\n", result.nodes);
+    std::cout << std::format("Таблица: {} MB\n", options.hashMb ? tt->sizeMb() : 0);
+    std::cout << std::format("Потоков: {} ({})\n", options.limits.threads,
+                             options.limits.parallel == ParallelMode::Ybwc ? "ybwc" : "lazy");
+    if (options.nnue) {
+        std::cout << std::format("Сеть: {} ({})\n", options.nnuePath, NnueNetwork::simdName());
+    }
+    std::cout << std::format("Время: {} ms\n", elapsed);
+    return 0;
+}
+
+// Checkers tbgen <фигур> [--dtw] [--out <каталог>]
+int tablebaseCommand(int argc, char* argv[]) {
+    TablebaseOptions options;
+    std::vector<std::string> args;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dtw") {
+            options.dtw = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outDir = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() != 1) {
+        std::cerr << "Использование: Checkers tbgen <фигур> [--dtw] [--out <каталог>]\n"
+                     "Базы строятся в памяти: до 5 фигур — около 0.6 ГБ, до 6 — около 10 ГБ\n";
+        return 1;
+    }
+    long long pieces = parseCount(args[0]);
+    if (pieces < 2 || pieces > MAX_TABLEBASE_PIECES) {
+        std::cerr << std::format("Некорректное число фигур: {} (от 2 до {})\n", args[0], MAX_TABLEBASE_PIECES);
+        return 1;
+    }
+    options.maxPieces = static_cast<int>(pieces);
+    try {
+        return runTablebaseGeneration(options);
+    } catch (const std::bad_alloc&) {
+        std::cerr << std::format("Не хватило памяти на базы до {} фигур\n", pieces);
+        return 1;
+    }
+}
+
 // -------------------- main --------------------
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "");
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    if (argc >= 2 && std::string(argv[1]) == "perft") {
+        return perftCommand(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "search") {
+        return searchCommand(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "tbgen") {
+        return tablebaseCommand(argc, argv);
+    }
+
+    // Настройки поиска компьютера: Checkers [--depth <N>] [--nodes <N>] [--time <ms>]
+    //                                       [--hash <MB>] [--threads <N>] [--parallel lazy|ybwc]
+    //                                       [--nnue <файл>]
+    SearchOptions options;
+    std::vector<std::string> unknown;
+    if (!parseSearchOptions(argc, argv, 1, options, unknown)) return 1;
+    if (!unknown.empty()) {
+        std::cerr << "Неизвестный аргумент: " << unknown[0] << "\n";
+        return 1;
+    }
+    // Таблица живёт всю партию: поиск следующего хода начинает с прошлых результатов
+    auto tt = makeTable(options.hashMb);
+    if (!tt) return 1;
+    TranspositionTable* ttPtr = options.hashMb ? tt.get() : nullptr;
     std::cout << "----ПРАВИЛА ИГРЫ В КЛАССИЧЕСКИЕ ШАШКИ----\n"
                  "1) Шашки ходят вперед. \n"
                  "2) Дамка ходит по диагонали на любое свободное поле как вперёд, так и назад, но не может перескакивать свои шашки или дамки.\n"
@@ -530,8 +394,8 @@ int main() {
     bool userIsWhite = (choice == 1);
 
     // Инициализируем доску
-    std::vector<std::vector<char>> board;
-    initBoard(board);
+    Position pos;
+    initBoard(pos);
 
     bool whiteMove = true;
     bool gameOver = false;
@@ -540,7 +404,7 @@ int main() {
     while (!gameOver) {
         auto startTime = std::chrono::steady_clock::now();
 
-        printBoard(board, userIsWhite);
+        printBoard(pos, userIsWhite);
 
         bool isUserTurn = ((whiteMove && userIsWhite) ||
                            (!whiteMove && !userIsWhite));
@@ -549,69 +413,58 @@ int main() {
                     (whiteMove ? "[Ход белых]" : "[Ход чёрных]"),
                     (isUserTurn ? "пользователь" : "компьютер"));
 
-        // Проверяем наличие ходов
-        if (!hasAnyMove(board, whiteMove)) {
+        // Один проход генератора: пустой список — ходов нет
+        MoveList moves;
+        generateLegalMoves(pos, whiteMove, moves);
+        if (moves.empty()) {
             std::cout << std::format("{} нет ходов! Игра завершена.\n",
                                      (whiteMove ? "У белых" : "У чёрных"));
             gameOver = true;
         } else {
-            // Пытаемся найти боевые ходы
-            auto captures = findAllCaptures(board, whiteMove);
-            if (!captures.empty()) {
+            if (captureCount(moves[0]) > 0) {
                 // Есть бой
                 if (isUserTurn) {
                     std::cout << "Обязательный бой!\n";
-                    humanMoveByCoords(board, captures, userIsWhite);
+                    humanMoveByCoords(pos, moves, userIsWhite);
                 } else {
-                    auto compMove = chooseComputerMove(captures);
+                    auto compMove = chooseComputerMove(pos, whiteMove, options.limits, ttPtr);
                     std::cout << std::format("Компьютер ({}) бьёт: ",
                                              (whiteMove ? "белые" : "чёрные"));
-                    for (size_t i = 0; i < compMove.steps.size(); i++) {
-                        auto &st = compMove.steps[i];
+                    auto path = movePath(pos, compMove);
+                    for (int i = 0; i < path.stepsCount; i++) {
+                        auto st = pathStep(path, i);
                         auto fs = cellToString(st.startRow, st.startCol, userIsWhite);
                         auto ls = cellToString(st.endRow, st.endCol, userIsWhite);
                         std::cout << std::format("({})->({})", fs, ls);
-                        if (i+1 < compMove.steps.size()) std::cout << ", ";
+                        if (i+1 < path.stepsCount) std::cout << ", ";
                     }
-                    std::cout << std::format(" [съедено: {}]\n", compMove.capturesCount);
-                    makeMoveSequence(board, compMove);
+                    std::cout << std::format(" [съедено: {}]\n", captureCount(compMove));
+                    makeMove(pos, compMove);
                 }
             } else {
                 // Обычные ходы
-                auto normals = findAllNormalMoves(board, whiteMove);
-                if (normals.empty()) {
-                    std::cout << "Нет ходов, завершаем.\n";
-                    gameOver = true;
+                if (isUserTurn) {
+                    humanMoveByCoords(pos, moves, userIsWhite);
                 } else {
-                    if (isUserTurn) {
-                        humanMoveByCoords(board, normals, userIsWhite);
-                    } else {
-                        auto compMove = chooseComputerMove(normals);
-                        auto &fs = compMove.steps.front();
-                        auto &ls = compMove.steps.back();
-                        auto fromStr = cellToString(fs.startRow, fs.startCol, userIsWhite);
-                        auto toStr   = cellToString(ls.endRow,   ls.endCol,   userIsWhite);
-                        std::cout << std::format(
-                            "Компьютер ({}) ходит: ({}) -> ({})\n",
-                            (whiteMove ? "белые" : "чёрные"),
-                            fromStr, toStr
-                        );
-                        makeMoveSequence(board, compMove);
-                    }
+                    auto compMove = chooseComputerMove(pos, whiteMove, options.limits, ttPtr);
+                    int fs = moveFrom(compMove);
+                    int ls = moveTo(compMove);
+                    auto fromStr = cellToString(squareRow(fs), squareCol(fs), userIsWhite);
+                    auto toStr   = cellToString(squareRow(ls), squareCol(ls), userIsWhite);
+                    std::cout << std::format(
+                        "Компьютер ({}) ходит: ({}) -> ({})\n",
+                        (whiteMove ? "белые" : "чёрные"),
+                        fromStr, toStr
+                    );
+                    makeMove(pos, compMove);
                 }
             }
         }
 
         // Проверяем, не выбиты ли все
         if (!gameOver) {
-            int whiteCount=0, blackCount=0;
-            for (int rr = 0; rr < BOARD_SIZE; rr++) {
-                for (int cc = 0; cc < BOARD_SIZE; cc++) {
-                    int col = pieceColor(board[rr][cc]);
-                    if (col == 1) ++whiteCount;
-                    if (col == -1) ++blackCount;
-                }
-            }
+            int whiteCount = pieceCount(pos, 1);
+            int blackCount = pieceCount(pos, -1);
             if (whiteCount == 0) {
                 std::cout << "Чёрные победили!\n";
                 gameOver = true;
@@ -0,0 +1,354 @@
+#include "movegen.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+
+// Обычные ходы для простой шашки
+void getManSimpleMoves(const Position& pos, int r, int c, int color, MoveList& out)
+{
+    int sq = squareIndex(r, c);
+    uint32_t occ = occupied(pos);
+    // Вперёд для белых — направления 2 и 3, для чёрных — 0 и 1 (сначала влево)
+    int firstDir = (color == 1) ? 2 : 0;
+    for (int d : {firstDir + 1, firstDir}) {
+        int to = DIAG.neighbour[sq][d];
+        if (to >= 0 && !(occ & (1u << to))) {
+            bool promotes = (promotionRow(color) >> to) & 1;
+            out.push(encodeMove(sq, to, 0, promotes));
+        }
+    }
+}
+
+// Обычные ходы для дамки
+void getKingSimpleMoves(const Position& pos, int r, int c, MoveList& out)
+{
+    int sq = squareIndex(r, c);
+    uint32_t bit = 1u << sq;
+    uint32_t empty = ~occupied(pos);
+    for (int d = 0; d < 4; ++d) {
+        uint32_t targets = occludedFill(bit, empty, d) & ~bit;
+        while (targets) {
+            int to = nearestSquare(targets, d);
+            targets &= ~(1u << to);
+            out.push(encodeMove(sq, to, 0, false));
+        }
+    }
+}
+
+// Состояние рекурсивного поиска боёв одной фигуры
+struct CaptureSearch {
+    int color = 0;
+    int origin = -1;                        // поле, с которого начат бой
+    uint32_t captured = 0;                  // побитые на текущем пути (ещё стоят на доске)
+    bool promoted = false;                  // шашка уже стала дамкой
+    MovePath path;                          // текущий путь
+    MoveList* out = nullptr;                // найденные ходы
+    int firstOut = 0;                       // первый ход этой фигуры в out
+    // Восстановление пути: если задан wanted, путь этого хода пишется в wantedPath
+    const Move* wanted = nullptr;
+    MovePath* wantedPath = nullptr;
+    bool found = false;
+};
+
+// Может ли дамка с поля sq бить дальше: foes — ещё не побитые фигуры соперника
+static bool kingCanCapture(int sq, uint32_t foes, uint32_t empty) {
+    uint32_t bit = 1u << sq;
+    for (int d = 0; d < 4; ++d) {
+        uint32_t target = stepSquares(occludedFill(bit, empty, d), d) & foes;
+        if (target && (stepSquares(target, d) & empty)) return true;
+    }
+    return false;
+}
+
+// Рекурсивный поиск боёв: одна позиция, ход делается и откатывается на месте.
+// Побитые фигуры снимаются только в конце хода (makeMove): до этого они
+// остаются на доске, мешают проходу и второй раз не бьются.
+void searchCaptures(Position& pos, int sq, CaptureSearch& cs)
+{
+    bool man = !(pos.kings & (1u << sq));
+    uint32_t foes = sidePieces(pos, -cs.color) & ~cs.captured;
+    uint32_t occ = occupied(pos);
+
+    // Шаг боя вглубь: сделать, рекурсивно продолжить, откатить
+    auto jump = [&](int land, int foe) {
+        StepUndo undo;
+        makeStep(pos, sq, land, -1, undo);
+        bool wasPromoted = cs.promoted;
+        cs.promoted = cs.promoted || undo.promoted;
+        cs.captured |= 1u << foe;
+        cs.path.squares[++cs.path.stepsCount] = land;
+
+        searchCaptures(pos, land, cs);
+
+        cs.path.stepsCount--;
+        cs.captured &= ~(1u << foe);
+        cs.promoted = wasPromoted;
+        unmakeStep(pos, undo);
+    };
+
+    bool foundFurther = false;
+
+    if (man) {
+        // Простая: через соседнее поле
+        for (int d = 0; d < 4; ++d) {
+            int mid = DIAG.neighbour[sq][d];
+            int land = DIAG.jump[sq][d];
+            if (land < 0) continue;
+            if ((foes & (1u << mid)) && !(occ & (1u << land))) {
+                jump(land, mid);
+                foundFurther = true;
+            }
+        }
+    } else {
+        // Дамка (дальний бой): пустые поля, фигура соперника, пустые поля за ней
+        uint32_t bit = 1u << sq;
+        uint32_t empty = ~occ;
+        for (int d = 0; d < 4; ++d) {
+            uint32_t target = stepSquares(occludedFill(bit, empty, d), d) & foes;
+            if (!target) continue;
+
+            int foe = std::countr_zero(target);
+            uint32_t landings = occludedFill(target, empty, d) & ~target;
+            // Если с каких-то полей бой продолжается, остановиться можно
+            // только на них: дамка бьёт, пока это возможно
+            uint32_t continuing = 0;
+            for (uint32_t rest = landings; rest; rest &= rest - 1) {
+                int land = std::countr_zero(rest);
+                uint32_t landBit = 1u << land;
+                if (kingCanCapture(land, foes & ~target, (empty | bit) & ~landBit)) continuing |= landBit;
+            }
+            if (continuing) landings = continuing;
+            while (landings) {
+                int land = nearestSquare(landings, d);
+                landings &= ~(1u << land);
+                jump(land, foe);
+                foundFurther = true;
+            }
+        }
+    }
+
+    if (!foundFurther && cs.captured != 0) {
+        // Пути с тем же набором побитых и тем же полем окончания дают
+        // одну и ту же позицию и упаковываются в один и тот же ход —
+        // второй раз его не добавляем
+        Move m = encodeMove(cs.origin, sq, cs.captured, cs.promoted);
+        if (cs.out && !cs.out->contains(m, cs.firstOut)) cs.out->push(m);
+        if (cs.wanted && !cs.found && *cs.wanted == m) {
+            *cs.wantedPath = cs.path;
+            cs.found = true;
+        }
+    }
+}
+
+// Все боевые ходы для фигуры
+void getAllCapturesForPiece(const Position& pos, int rr, int cc, MoveList& out)
+{
+    if (pieceColor(pos, rr, cc) == 0) return;
+
+    Position work = pos;
+    CaptureSearch cs;
+    cs.color = pieceColor(pos, rr, cc);
+    cs.origin = squareIndex(rr, cc);
+    cs.path.squares[0] = cs.origin;
+    cs.out = &out;
+    cs.firstOut = out.size();
+
+    searchCaptures(work, cs.origin, cs);
+}
+
+// Восстановить поля приземления хода (нужно только для вывода)
+MovePath movePath(const Position& pos, Move m)
+{
+    MovePath path;
+    path.squares[0] = moveFrom(m);
+    path.squares[1] = moveTo(m);
+    path.stepsCount = 1;
+    if (moveCaptured(m) == 0) return path;
+
+    int from = moveFrom(m);
+    Position work = pos;
+    CaptureSearch cs;
+    cs.color = pieceColor(pos, squareRow(from), squareCol(from));
+    cs.origin = from;
+    cs.path.squares[0] = from;
+    cs.wanted = &m;
+    cs.wantedPath = &path;
+
+    searchCaptures(work, from, cs);
+    return path;
+}
+
+// Добавить в out ходы из частичного списка
+static void appendMoves(MoveList& out, const MoveList& part) {
+    for (Move m : part) {
+        out.push(m);
+    }
+}
+
+// Генератор ходов одной фигуры (поле sq, цвет color)
+using PieceMoveGen = void (*)(const Position& pos, int sq, int color, MoveList& out);
+
+// Оценка объёма генерации: дамка с дальним боем стоит примерно как 8 шашек.
+// Меньше порога — считаем на месте, отдавать такую работу в пул дороже.
+static constexpr int PARALLEL_MOVEGEN_MIN_WORK = 64;
+
+static int movegenWork(const Position& pos, uint32_t pieces) {
+    return std::popcount(pieces & ~pos.kings) + 8 * std::popcount(pieces & pos.kings);
+}
+
+// Обойти фигуры стороны: на месте или кусками по строкам в пуле движка
+static void generateForPieces(const Position& pos, uint32_t own, int color,
+                              MoveList& out, PieceMoveGen gen, bool parallel)
+{
+    if (!parallel || movegenWork(pos, own) < PARALLEL_MOVEGEN_MIN_WORK
+        || enginePool().size() < 2) {
+        while (own) {
+            int sq = std::countr_zero(own);
+            own &= own - 1;
+            gen(pos, sq, color, out);
+        }
+        return;
+    }
+
+    ThreadPool& pool = enginePool();
+    int chunkSize = BOARD_SIZE / static_cast<int>(pool.size());
+    if (chunkSize < 1) chunkSize = 1;
+
+    // Части пишутся в свои списки и сливаются по порядку строк
+    MoveList parts[BOARD_SIZE];
+    int partCount = 0;
+    {
+        TaskGroup group(pool);
+        for (int rowSt = 0; rowSt < BOARD_SIZE; rowSt += chunkSize) {
+            int rowEnd = std::min(rowSt + chunkSize, BOARD_SIZE);
+            MoveList* local = &parts[partCount++];
+            group.run([rowSt,rowEnd,own,color,gen,local,&pos]() {
+                uint32_t pieces = 0;
+                for (int rr = rowSt; rr < rowEnd; ++rr) {
+                    pieces |= rowMask(rr);
+                }
+                pieces &= own;
+                while (pieces) {
+                    int sq = std::countr_zero(pieces);
+                    pieces &= pieces - 1;
+                    gen(pos, sq, color, *local);
+                }
+            });
+        }
+        group.wait();
+    }
+
+    for (int i = 0; i < partCount; ++i) {
+        appendMoves(out, parts[i]);
+    }
+}
+
+static void capturesForSquare(const Position& pos, int sq, int, MoveList& out) {
+    getAllCapturesForPiece(pos, squareRow(sq), squareCol(sq), out);
+}
+
+static void normalMovesForSquare(const Position& pos, int sq, int color, MoveList& out) {
+    int rr = squareRow(sq);
+    int cc = squareCol(sq);
+    if (!(pos.kings & (1u << sq))) {
+        getManSimpleMoves(pos, rr, cc, color, out);
+    } else {
+        getKingSimpleMoves(pos, rr, cc, out);
+    }
+}
+
+// Фигуры стороны color, которым есть кого бить. Шашки и дамки проверяются
+// сразу все: жертва — фигура соперника с пустым полем за ней, дамка
+// дотягивается до неё заполнением по пустым полям.
+uint32_t capturingPieces(const Position& pos, int color)
+{
+    uint32_t own = sidePieces(pos, color);
+    uint32_t foes = sidePieces(pos, -color);
+    uint32_t empty = ~occupied(pos);
+    uint32_t men = own & ~pos.kings;
+    uint32_t kings = own & pos.kings;
+    uint32_t result = 0;
+    for (int d = 0; d < 4; ++d) {
+        int back = oppositeDirection(d);
+        uint32_t victims = foes & stepSquares(empty, back);
+        result |= men & stepSquares(victims, back);
+        if (kings) {
+            uint32_t hit = stepSquares(occludedFill(kings, empty, d), d) & victims;
+            result |= kings & stepSquares(occludedFill(hit, empty, back), back);
+        }
+    }
+    return result;
+}
+
+// Фигуры стороны color, у которых есть тихий ход
+uint32_t movablePieces(const Position& pos, int color)
+{
+    uint32_t own = sidePieces(pos, color);
+    uint32_t empty = ~occupied(pos);
+    int firstDir = (color == 1) ? 2 : 0;
+    uint32_t result = 0;
+    for (int d = 0; d < 4; ++d) {
+        uint32_t movers = (d == firstDir || d == firstDir + 1) ? own : (own & pos.kings);
+        result |= movers & stepSquares(empty, oppositeDirection(d));
+    }
+    return result;
+}
+
+// Поиск боёв (крупная работа делится между потоками пула)
+void findAllCaptures(const Position& pos, bool whiteTurn, MoveList& out, bool parallel)
+{
+    int color = whiteTurn ? 1 : -1;
+    generateForPieces(pos, capturingPieces(pos, color), color, out, capturesForSquare, parallel);
+}
+
+// Поиск обычных ходов (крупная работа делится между потоками пула)
+void findAllNormalMoves(const Position& pos, bool whiteTurn, MoveList& out, bool parallel)
+{
+    int color = whiteTurn ? 1 : -1;
+    generateForPieces(pos, movablePieces(pos, color), color, out, normalMovesForSquare, parallel);
+}
+
+// Все легальные ходы: при наличии боя — только бои (взятие обязательно)
+void generateLegalMoves(const Position& pos, bool whiteTurn, MoveList& out, bool parallel)
+{
+    int start = out.size();
+    findAllCaptures(pos, whiteTurn, out, parallel);
+    if (out.size() > start) return;
+    findAllNormalMoves(pos, whiteTurn, out, parallel);
+}
+
+// Проверка, есть ли вообще ход: только множественные сдвиги, без построения боёв
+bool hasAnyMove(const Position& pos, bool whiteTurn) {
+    int color = (whiteTurn ? 1 : -1);
+    return movablePieces(pos, color) != 0 || capturingPieces(pos, color) != 0;
+}
+
+// Возможен ли тихий ход m стороны whiteTurn (без учёта обязательного боя)
+bool isQuietMoveValid(const Position& pos, bool whiteTurn, Move m) {
+    int color = whiteTurn ? 1 : -1;
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    uint32_t fromBit = 1u << from;
+    uint32_t toBit = 1u << to;
+    if (moveCaptured(m) != 0 || !(sidePieces(pos, color) & fromBit) || (occupied(pos) & toBit)) {
+        return false;
+    }
+
+    if (!(pos.kings & fromBit)) {
+        // Шашка: на соседнее поле вперёд, флаг превращения должен совпасть
+        int firstDir = (color == 1) ? 2 : 0;
+        bool promotes = (promotionRow(color) & toBit) != 0;
+        return movePromotes(m) == promotes
+            && (DIAG.neighbour[from][firstDir] == to || DIAG.neighbour[from][firstDir + 1] == to);
+    }
+
+    // Дамка: поле на одном из лучей, до него всё пусто
+    if (movePromotes(m)) return false;
+    uint32_t empty = ~occupied(pos);
+    for (int d = 0; d < 4; ++d) {
+        if (DIAG.rayMask[from][d] & toBit) {
+            return (occludedFill(fromBit, empty, d) & toBit) != 0;
+        }
+    }
+    return false;
+}
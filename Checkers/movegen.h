@@ -0,0 +1,30 @@
+#pragma once
+
+#include "board.h"
+
+// Обычные ходы для простой шашки
+void getManSimpleMoves(const Position& pos, int r, int c, int color, MoveList& out);
+// Обычные ходы для дамки
+void getKingSimpleMoves(const Position& pos, int r, int c, MoveList& out);
+// Все боевые ходы для фигуры
+void getAllCapturesForPiece(const Position& pos, int rr, int cc, MoveList& out);
+// Восстановить поля приземления хода (нужно только для вывода)
+MovePath movePath(const Position& pos, Move m);
+
+// Фигуры стороны color, которым есть кого бить
+uint32_t capturingPieces(const Position& pos, int color);
+// Фигуры стороны color, у которых есть тихий ход
+uint32_t movablePieces(const Position& pos, int color);
+
+// Поиск боёв (крупная работа делится между потоками пула).
+// parallel = false — всегда в вызывающем потоке: поиск и так занимает все ядра.
+void findAllCaptures(const Position& pos, bool whiteTurn, MoveList& out, bool parallel = true);
+// Поиск обычных ходов (крупная работа делится между потоками пула)
+void findAllNormalMoves(const Position& pos, bool whiteTurn, MoveList& out, bool parallel = true);
+// Все легальные ходы: при наличии боя — только бои (взятие обязательно)
+void generateLegalMoves(const Position& pos, bool whiteTurn, MoveList& out, bool parallel = true);
+// Проверка, есть ли вообще ход
+bool hasAnyMove(const Position& pos, bool whiteTurn);
+// Возможен ли тихий ход m стороны whiteTurn (без учёта обязательного боя).
+// Нужен, чтобы сыграть ход из таблиц сортировки, не генерируя остальные.
+bool isQuietMoveValid(const Position& pos, bool whiteTurn, Move m);
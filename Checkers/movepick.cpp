@@ -0,0 +1,139 @@
+#include "movepick.h"
+#include "movegen.h"
+#include "tt.h"
+
+#include <algorithm>
+
+// Предел истории: дальше все значения делятся пополам
+static constexpr int HISTORY_MAX = 1 << 20;
+// Ход из таблицы транспозиций среди взятий идёт первым
+static constexpr int HASH_CAPTURE_BONUS = 1 << 16;
+
+void OrderingTables::clear() {
+    *this = OrderingTables{};
+}
+
+// Тихий ход m дал отсечение на глубине depth в ответ на ход prev
+void OrderingTables::updateQuiet(Move m, bool whiteTurn, int depth, int ply, Move prev) {
+    if (ply < MAX_PLY && killers[ply][0] != m) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = m;
+    }
+
+    int &h = history[whiteTurn ? 0 : 1][moveFrom(m)][moveTo(m)];
+    h += depth * depth;
+    if (h > HISTORY_MAX) {
+        for (auto &side : history) {
+            for (auto &row : side) {
+                for (int &value : row) value /= 2;
+            }
+        }
+    }
+
+    if (prev != Move{}) counter[moveFrom(prev)][moveTo(prev)] = m;
+}
+
+MovePicker::MovePicker(const Position& pos, bool whiteTurn, uint32_t hashMove,
+                       const OrderingTables& tables, int ply, Move prev)
+    : pos(pos), whiteTurn(whiteTurn), hashMove(hashMove), tables(tables), ply(ply), prev(prev)
+{
+    // Бой обязателен: проверяется сразу по всем фигурам, без построения ходов
+    captures = capturingPieces(pos, whiteTurn ? 1 : -1) != 0;
+    stage = captures ? Stage::Captures : Stage::HashMove;
+}
+
+Move MovePicker::pickBest() {
+    if (current >= moves.size()) return Move{};
+    int best = current;
+    for (int i = current + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves.moves[current], moves.moves[best]);
+    std::swap(scores[current], scores[best]);
+    return moves[current++];
+}
+
+bool MovePicker::alreadyTried(Move m) const {
+    for (int i = 0; i < triedCount; ++i) {
+        if (tried[i] == m) return true;
+    }
+    return false;
+}
+
+bool MovePicker::acceptSpecial(Move m) {
+    if (m == Move{} || alreadyTried(m) || !isQuietMoveValid(pos, whiteTurn, m)) return false;
+    tried[triedCount++] = m;
+    return true;
+}
+
+Move MovePicker::next() {
+    while (true) {
+        switch (stage) {
+        case Stage::Captures:
+            // Взятия: все сразу, ход из таблицы первым, дальше больше побитых
+            // и превращение
+            findAllCaptures(pos, whiteTurn, moves, false);
+            for (int i = 0; i < moves.size(); ++i) {
+                Move m = moves[i];
+                scores[i] = captureCount(m) * 16 + (movePromotes(m) ? 8 : 0);
+                if (hashMove != 0 && compactMove(m) == hashMove) scores[i] += HASH_CAPTURE_BONUS;
+            }
+            stage = Stage::Quiets;
+            break;
+
+        case Stage::HashMove: {
+            // У тихого хода в записи таблицы есть всё: поля и превращение
+            stage = Stage::Killer1;
+            Move m{hashMove & 0x7FF};
+            if ((hashMove >> 11) == 0 && acceptSpecial(m)) return m;
+            break;
+        }
+
+        case Stage::Killer1:
+            stage = Stage::Killer2;
+            if (ply < MAX_PLY && acceptSpecial(tables.killers[ply][0])) {
+                return tables.killers[ply][0];
+            }
+            break;
+
+        case Stage::Killer2:
+            stage = Stage::CounterMove;
+            if (ply < MAX_PLY && acceptSpecial(tables.killers[ply][1])) {
+                return tables.killers[ply][1];
+            }
+            break;
+
+        case Stage::CounterMove:
+            stage = Stage::GenerateQuiets;
+            if (prev != Move{}) {
+                Move m = tables.counter[moveFrom(prev)][moveTo(prev)];
+                if (acceptSpecial(m)) return m;
+            }
+            break;
+
+        case Stage::GenerateQuiets: {
+            // Остальные тихие ходы по истории; уже выданные выбрасываются
+            MoveList all;
+            findAllNormalMoves(pos, whiteTurn, all, false);
+            const auto &history = tables.history[whiteTurn ? 0 : 1];
+            for (Move m : all) {
+                if (alreadyTried(m)) continue;
+                scores[moves.size()] = history[moveFrom(m)][moveTo(m)];
+                moves.push(m);
+            }
+            stage = Stage::Quiets;
+            break;
+        }
+
+        case Stage::Quiets: {
+            Move m = pickBest();
+            if (m != Move{}) return m;
+            stage = Stage::Done;
+            break;
+        }
+
+        case Stage::Done:
+            return Move{};
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "board.h"
+#include "search.h"
+
+#include <cstdint>
+
+// -------------------- Сортировка ходов --------------------
+// Таблицы сортировки одного потока поиска
+struct OrderingTables {
+    Move killers[MAX_PLY][2] = {};                    // тихие ходы, давшие отсечение на этом ply
+    int history[2][SQUARE_COUNT][SQUARE_COUNT] = {};  // [сторона][откуда][куда]
+    Move counter[SQUARE_COUNT][SQUARE_COUNT] = {};    // ответ на ход соперника [откуда][куда]
+
+    void clear();
+    // Тихий ход m дал отсечение на глубине depth в ответ на ход prev
+    void updateQuiet(Move m, bool whiteTurn, int depth, int ply, Move prev);
+};
+
+// Поэтапная выдача ходов: ход из таблицы транспозиций; при обязательном
+// бое — взятия по числу побитых и превращению; иначе — два хода-убийцы,
+// ответный ход и остальные тихие ходы по истории. Ходы следующего этапа
+// генерируются только когда до него дошло дело.
+class MovePicker {
+public:
+    MovePicker(const Position& pos, bool whiteTurn, uint32_t hashMove,
+               const OrderingTables& tables, int ply, Move prev);
+
+    // Следующий ход, Move{} — ходов больше нет
+    Move next();
+    // Позиция с обязательным боем: все ходы — взятия
+    bool capturesOnly() const { return captures; }
+
+private:
+    enum class Stage {
+        Captures, HashMove, Killer1, Killer2, CounterMove, GenerateQuiets, Quiets, Done,
+    };
+
+    // Ход с наибольшей оценкой среди ещё не выданных (сортировка выбором)
+    Move pickBest();
+    // Тихий ход из таблиц: возможен и ещё не выдан
+    bool acceptSpecial(Move m);
+    bool alreadyTried(Move m) const;
+
+    const Position& pos;
+    bool whiteTurn;
+    uint32_t hashMove;
+    const OrderingTables& tables;
+    int ply;
+    Move prev;
+
+    bool captures = false;
+    Stage stage;
+    MoveList moves;
+    int scores[MAX_MOVES];
+    int current = 0;
+    Move tried[4];          // ходы из таблиц, уже выданные до генерации
+    int triedCount = 0;
+};
@@ -0,0 +1,237 @@
+#include "nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+static constexpr char NNUE_MAGIC[4] = {'C', 'K', 'N', 'N'};
+static constexpr uint32_t NNUE_VERSION = 1;
+
+// -------------------- Ядра --------------------
+// Длины кратны 32, число строк слоя — 4: на это рассчитаны все три варианта.
+
+// acc += column
+static void addColumn(int16_t* acc, const int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] = static_cast<int16_t>(acc[i] + column[i]);
+#endif
+}
+
+// acc -= column
+static void subColumn(int16_t* acc, const int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] = static_cast<int16_t>(acc[i] - column[i]);
+#endif
+}
+
+// out = clamp(in, 0, 127) для n значений
+static void clippedRelu(const int16_t* in, uint8_t* out, int n) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 32) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+        // Упаковка с насыщением до 127 перемежает 128-битные половины — возвращаем порядок
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_max_epi8(packed, zero));
+    }
+#elif defined(__SSE4_1__)
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < n; i += 16) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_max_epi8(_mm_packs_epi16(a, b), zero));
+    }
+#else
+    for (int i = 0; i < n; ++i) out[i] = static_cast<uint8_t>(std::clamp<int>(in[i], 0, 127));
+#endif
+}
+
+// Полносвязный слой: out[j] = bias[j] + сумма in[i] * weights[j][i],
+// вход uint8 (0..127), веса int8, n входов, rows выходов (кратно 4).
+// Четыре строки считаются вместе: у каждой своя цепочка сложений.
+static void dense(const uint8_t* in, const int8_t* weights, const int32_t* bias,
+                  int n, int rows, int32_t* out) {
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    // Пары произведений в int16 (127 * 127 * 2 не переполняет), затем в int32
+    auto product = [&](__m256i x, const int8_t* row) {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+        return _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones);
+    };
+    for (int j = 0; j < rows; j += 4) {
+        const int8_t* row = weights + j * n;
+        __m256i sum0 = _mm256_setzero_si256(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (int i = 0; i < n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            sum0 = _mm256_add_epi32(sum0, product(x, row + i));
+            sum1 = _mm256_add_epi32(sum1, product(x, row + n + i));
+            sum2 = _mm256_add_epi32(sum2, product(x, row + 2 * n + i));
+            sum3 = _mm256_add_epi32(sum3, product(x, row + 3 * n + i));
+        }
+        // Горизонтальные суммы четырёх строк разом
+        __m256i s = _mm256_hadd_epi32(_mm256_hadd_epi32(sum0, sum1), _mm256_hadd_epi32(sum2, sum3));
+        __m128i total = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + j)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), total);
+    }
+#elif defined(__SSE4_1__)
+    const __m128i ones = _mm_set1_epi16(1);
+    auto product = [&](__m128i x, const int8_t* row) {
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        return _mm_madd_epi16(_mm_maddubs_epi16(x, w), ones);
+    };
+    for (int j = 0; j < rows; j += 4) {
+        const int8_t* row = weights + j * n;
+        __m128i sum0 = _mm_setzero_si128(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (int i = 0; i < n; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            sum0 = _mm_add_epi32(sum0, product(x, row + i));
+            sum1 = _mm_add_epi32(sum1, product(x, row + n + i));
+            sum2 = _mm_add_epi32(sum2, product(x, row + 2 * n + i));
+            sum3 = _mm_add_epi32(sum3, product(x, row + 3 * n + i));
+        }
+        __m128i total = _mm_hadd_epi32(_mm_hadd_epi32(sum0, sum1), _mm_hadd_epi32(sum2, sum3));
+        total = _mm_add_epi32(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + j)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), total);
+    }
+#else
+    for (int j = 0; j < rows; ++j) {
+        int32_t sum = bias[j];
+        for (int i = 0; i < n; ++i) sum += in[i] * weights[j * n + i];
+        out[j] = sum;
+    }
+#endif
+}
+
+const char* NnueNetwork::simdName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE4_1__)
+    return "sse4.1";
+#else
+    return "scalar";
+#endif
+}
+
+// -------------------- Признаки --------------------
+// Номер признака фигуры с точки зрения перспективы view (sideIndex):
+// для чёрных доска повёрнута на 180 градусов, свои фигуры — «белые»
+static int featureIndex(int view, int color, bool king, int sq) {
+    if (view == 0) return pieceKind(color, king) * SQUARE_COUNT + sq;
+    return pieceKind(-color, king) * SQUARE_COUNT + (SQUARE_COUNT - 1 - sq);
+}
+
+// -------------------- Загрузка --------------------
+template <class T>
+static bool readArray(std::ifstream &in, T* data, size_t count) {
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+    return static_cast<bool>(in);
+}
+
+bool NnueNetwork::load(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t header[4];
+    if (!readArray(in, magic, 4) || std::memcmp(magic, NNUE_MAGIC, 4) != 0) return false;
+    if (!readArray(in, header, 4)) return false;
+    if (header[0] != NNUE_VERSION || header[1] != NNUE_FEATURES
+        || header[2] != NNUE_HIDDEN || header[3] != NNUE_L2) {
+        return false;
+    }
+
+    bool ok = readArray(in, featureBias, NNUE_HIDDEN)
+           && readArray(in, &featureWeights[0][0], NNUE_FEATURES * NNUE_HIDDEN)
+           && readArray(in, l2Bias, NNUE_L2)
+           && readArray(in, &l2Weights[0][0], NNUE_L2 * 2 * NNUE_HIDDEN)
+           && readArray(in, &outputBias, 1)
+           && readArray(in, outputWeights, NNUE_L2);
+    // Лишние байты в конце — тоже не наш формат
+    return ok && in.peek() == std::ifstream::traits_type::eof();
+}
+
+// -------------------- Вычисление --------------------
+void NnueNetwork::refresh(const Position& pos, NnueAccumulator& acc) const {
+    for (int view = 0; view < 2; ++view) {
+        std::memcpy(acc.values[view], featureBias, sizeof(featureBias));
+        for (int color : {1, -1}) {
+            for (uint32_t pieces = sidePieces(pos, color); pieces; pieces &= pieces - 1) {
+                int sq = std::countr_zero(pieces);
+                bool king = (pos.kings >> sq) & 1;
+                addColumn(acc.values[view], featureWeights[featureIndex(view, color, king, sq)]);
+            }
+        }
+    }
+}
+
+// Ход целиком меняет немного признаков: фигура уходит с поля начала,
+// появляется на поле окончания (возможно, уже дамкой), побитые снимаются
+void NnueNetwork::update(const NnueAccumulator& parent, const Position& pos, Move m,
+                         NnueAccumulator& child) const {
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    int color = ((pos.white >> from) & 1) ? 1 : -1;
+    bool wasKing = (pos.kings >> from) & 1;
+    bool king = wasKing || movePromotes(m);
+
+    child = parent;
+    for (int view = 0; view < 2; ++view) {
+        int16_t* acc = child.values[view];
+        subColumn(acc, featureWeights[featureIndex(view, color, wasKing, from)]);
+        addColumn(acc, featureWeights[featureIndex(view, color, king, to)]);
+        for (uint32_t rest = moveCaptured(m); rest; rest &= rest - 1) {
+            int sq = std::countr_zero(rest);
+            subColumn(acc, featureWeights[featureIndex(view, -color, (pos.kings >> sq) & 1, sq)]);
+        }
+    }
+}
+
+int NnueNetwork::evaluate(const NnueAccumulator& acc, int color) const {
+    // Вход второго слоя: сначала перспектива стороны хода, затем соперника
+    alignas(32) uint8_t input[2 * NNUE_HIDDEN];
+    int own = sideIndex(color);
+    clippedRelu(acc.values[own], input, NNUE_HIDDEN);
+    clippedRelu(acc.values[1 - own], input + NNUE_HIDDEN, NNUE_HIDDEN);
+
+    alignas(32) int32_t l2[NNUE_L2];
+    dense(input, &l2Weights[0][0], l2Bias, 2 * NNUE_HIDDEN, NNUE_L2, l2);
+
+    // Выходной слой — одна строка из NNUE_L2 весов, хватает скалярного цикла
+    int32_t sum = outputBias;
+    for (int j = 0; j < NNUE_L2; ++j) {
+        sum += std::clamp(l2[j] >> NNUE_L2_SHIFT, 0, 127) * outputWeights[j];
+    }
+    return sum / NNUE_OUTPUT_SCALE;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+#include <string>
+
+// -------------------- Оценка нейросетью (NNUE) --------------------
+// Входы — вид фигуры × поле (128 признаков) с точки зрения каждой стороны:
+// для чёрных доска повёрнута и цвета переставлены, веса общие.
+// Первый слой (аккумулятор) не пересчитывается в каждом узле: ход меняет
+// несколько признаков, и аккумулятор потомка — это аккумулятор родителя
+// плюс/минус их столбцы весов.
+//
+//   признаки (128) -> 2 x NNUE_HIDDEN (int16, аккумулятор по перспективам)
+//   -> clipped ReLU 0..127 (uint8) -> NNUE_L2 (веса int8) -> clipped ReLU
+//   -> 1 выход (веса int8)
+//
+// Ядра — AVX2 или SSE4.1 (по флагам компиляции), иначе скалярные.
+
+static constexpr int NNUE_FEATURES = 4 * SQUARE_COUNT;
+static constexpr int NNUE_HIDDEN = 128;
+static constexpr int NNUE_L2 = 32;
+
+// Аккумулятор первого слоя: [перспектива][нейрон], перспектива — sideIndex.
+// Без инициализации: в поиске он лежит в каждом кадре рекурсии.
+struct alignas(32) NnueAccumulator {
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+// Файл весов (little-endian):
+//   "CKNN", uint32 версия (1), uint32 NNUE_FEATURES, NNUE_HIDDEN, NNUE_L2,
+//   int16 смещения[NNUE_HIDDEN], int16 веса[NNUE_FEATURES][NNUE_HIDDEN],
+//   int32 смещения[NNUE_L2], int8 веса[NNUE_L2][2 * NNUE_HIDDEN],
+//   int32 смещение выхода, int8 веса выхода[NNUE_L2].
+// Второй слой сдвигается на NNUE_L2_SHIFT, выход делится на NNUE_OUTPUT_SCALE
+// и получается в единицах оценки (простая шашка = 100).
+static constexpr int NNUE_L2_SHIFT = 6;
+static constexpr int NNUE_OUTPUT_SCALE = 16;
+
+class NnueNetwork {
+public:
+    // Загрузить веса из файла; false — файла нет или формат не тот
+    bool load(const std::string &path);
+
+    // Аккумулятор позиции с нуля (корень поиска)
+    void refresh(const Position& pos, NnueAccumulator& acc) const;
+    // Аккумулятор после хода m из позиции pos (позиция — до хода)
+    void update(const NnueAccumulator& parent, const Position& pos, Move m,
+                NnueAccumulator& child) const;
+    // Оценка со стороны color по готовому аккумулятору
+    int evaluate(const NnueAccumulator& acc, int color) const;
+
+    // Набор команд, под который собраны ядра: "avx2", "sse4.1" или "scalar"
+    static const char* simdName();
+
+private:
+    alignas(32) int16_t featureBias[NNUE_HIDDEN];
+    alignas(32) int16_t featureWeights[NNUE_FEATURES][NNUE_HIDDEN];
+    alignas(32) int32_t l2Bias[NNUE_L2];
+    alignas(32) int8_t l2Weights[NNUE_L2][2 * NNUE_HIDDEN];
+    int32_t outputBias;
+    alignas(32) int8_t outputWeights[NNUE_L2];
+};
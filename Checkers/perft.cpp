@@ -0,0 +1,86 @@
+#include "perft.h"
+#include "movegen.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// Число листьев дерева ходов глубины depth. Последний полуход
+// считается целиком: листья — это просто размер списка ходов.
+uint64_t perft(const Position &pos, bool whiteTurn, int depth, PerftCache *cache) {
+    if (depth <= 0) return 1;
+
+    MoveList moves;
+    if (depth == 1) {
+        generateLegalMoves(pos, whiteTurn, moves);
+        return static_cast<uint64_t>(moves.size());
+    }
+
+    // Кэш смотрим до генерации: при попадании ходы не нужны
+    uint64_t key = 0;
+    if (cache) {
+        key = positionHash(pos, whiteTurn);
+        uint64_t cached;
+        if (cache->probe(key, depth, cached)) return cached;
+    }
+
+    generateLegalMoves(pos, whiteTurn, moves);
+    uint64_t nodes = 0;
+    for (Move m : moves) {
+        Position next = pos;
+        makeMove(next, m);
+        nodes += perft(next, !whiteTurn, depth - 1, cache);
+    }
+
+    if (cache) cache->store(key, depth, nodes);
+    return nodes;
+}
+
+// Perft с разбивкой по ходам из корня; поддеревья считаются в пуле движка.
+// hashMb — размер общего кэша в мегабайтах (0 — без кэша).
+int runPerft(const Position &pos, bool whiteTurn, int depth, size_t hashMb) {
+    auto startTime = std::chrono::steady_clock::now();
+    PerftCache cache(hashMb);
+    PerftCache *cachePtr = (hashMb > 0) ? &cache : nullptr;
+
+    // На нулевой глубине корневых ходов не делаем: лист — сама позиция
+    MoveList moves;
+    if (depth > 0) generateLegalMoves(pos, whiteTurn, moves);
+
+    std::vector<uint64_t> counts(moves.size(), 0);
+    {
+        TaskGroup group(enginePool());
+        for (int i = 0; i < moves.size(); ++i) {
+            group.run([&pos, &moves, &counts, cachePtr, whiteTurn, depth, i]() {
+                Position next = pos;
+                makeMove(next, moves[i]);
+                counts[i] = perft(next, !whiteTurn, depth - 1, cachePtr);
+            });
+        }
+        group.wait();
+    }
+
+    uint64_t total = (depth == 0) ? 1 : 0;
+    if (depth > 0) {
+        for (int i = 0; i < moves.size(); ++i) {
+            std::cout << std::format("{}: {}\n", moveToString(moves[i]), counts[i]);
+            total += counts[i];
+        }
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    double seconds = std::max<double>(elapsed, 1) / 1e6;
+
+    std::cout << std::format("\nПозиция: {}\n", positionToString(pos, whiteTurn));
+    std::cout << std::format("Глубина: {}\n", depth);
+    std::cout << std::format("Кэш: {} MB\n", hashMb);
+    std::cout << std::format("Узлов: {}\n", total);
+    std::cout << std::format("Время: {} ms\n", elapsed / 1000);
+    std::cout << std::format("Скорость: {} узлов/с\n", static_cast<uint64_t>(total / seconds));
+    return 0;
+}
+
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "board.h"
+#include "hash_table.h"
+
+#include <cstddef>
+#include <memory>
+
+// -------------------- Perft --------------------
+// Общий для всех потоков кэш perft: ключ — хэш позиции и оставшаяся глубина.
+// Слоты без блокировок, см. LocklessSlot.
+class PerftCache {
+public:
+    explicit PerftCache(size_t megabytes)
+        : enabled(megabytes > 0) {
+        size_t count = enabled ? hashTableCount(megabytes, sizeof(LocklessSlot)) : 0;
+        slots = std::make_unique<LocklessSlot[]>(count);
+        mask = count ? count - 1 : 0;
+    }
+
+    bool probe(uint64_t key, int depth, uint64_t &nodes) const {
+        if (!enabled) return false;
+        uint64_t data;
+        if (!slots[key & mask].load(key, data) || static_cast<int>(data & 0xFF) != depth) return false;
+        nodes = data >> 8;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        if (!enabled) return;
+        slots[key & mask].store(key, (nodes << 8) | static_cast<uint64_t>(depth & 0xFF));
+    }
+
+private:
+    std::unique_ptr<LocklessSlot[]> slots;
+    size_t mask = 0;
+    bool enabled = false;
+};
+
+// Число листьев дерева ходов глубины depth (последний полуход — целиком)
+uint64_t perft(const Position &pos, bool whiteTurn, int depth, PerftCache *cache = nullptr);
+// Perft с разбивкой по ходам из корня; hashMb — размер общего кэша (0 — без кэша)
+int runPerft(const Position &pos, bool whiteTurn, int depth, size_t hashMb);
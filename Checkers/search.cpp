@@ -0,0 +1,509 @@
+#include "search.h"
+#include "eval.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "nnue.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using SearchClock = std::chrono::steady_clock;
+
+// Часы опрашиваются раз в столько узлов: это доли миллисекунды
+static constexpr uint64_t TIME_CHECK_NODES = 1024;
+
+// Тихий поиск за горизонтом: не больше стольких узлов на один лист
+static constexpr int QSEARCH_NODE_BUDGET = 2048;
+
+// YBWC: узел делится между потоками не ближе стольких полуходов к листьям,
+// иначе раздача задач стоит дороже самого поиска
+static constexpr int YBWC_MIN_SPLIT_DEPTH = 3;
+
+// Оценка сети не должна выглядеть как найденный выигрыш
+static constexpr int NNUE_SCORE_LIMIT = SCORE_WIN - MAX_PLY - 1;
+
+// Общее для всех потоков одного поиска
+struct SharedSearch {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> nodes{0};     // пополняется пачками по TIME_CHECK_NODES
+    uint64_t nodeLimit = 0;             // 0 — без ограничения
+    bool hasDeadline = false;
+    SearchClock::time_point hardDeadline;
+    ThreadPool* pool = nullptr;         // режим YBWC: пул для младших братьев
+    std::atomic<int> freeWorkers{0};    // сколько ещё потоков пула можно занять
+};
+
+// Точка разделения YBWC: узел, чьи ходы после первого ищутся задачами пула
+struct SplitPoint {
+    const SplitPoint* parent = nullptr;
+    std::atomic<int> alpha{0};
+    int beta = 0;
+    std::atomic<bool> cutoff{false};    // найдено отсечение — остальным задачам не работать
+    std::mutex mutex;                   // защищает best и bestMove
+    int best = -SCORE_INFINITY;
+    Move bestMove{};
+    std::atomic<int> next{0};           // следующий ещё не взятый ход
+    std::atomic<uint64_t> nodes{0};     // узлы, просмотренные задачами
+};
+
+// Состояние одного потока (или одной задачи YBWC) поиска
+struct SearchContext {
+    SharedSearch* shared = nullptr;
+    TranspositionTable* tt = nullptr;
+    const SplitPoint* split = nullptr;  // ближайшая точка разделения над узлом
+    OrderingTables* order = nullptr;    // таблицы сортировки потока
+    const NnueNetwork* nnue = nullptr;  // оценка сетью, nullptr — ручная
+    uint64_t nodes = 0;
+    bool stopped = false;       // поиск остановлен, результат итерации не доверять
+};
+
+// Остановлен ли поиск целиком или отсечена одна из точек разделения выше
+static bool checkAborted(SearchContext& ctx) {
+    if (ctx.shared->stop.load(std::memory_order_relaxed)) {
+        ctx.stopped = true;
+    } else {
+        for (const SplitPoint* sp = ctx.split; sp; sp = sp->parent) {
+            if (sp->cutoff.load(std::memory_order_relaxed)) {
+                ctx.stopped = true;
+                break;
+            }
+        }
+    }
+    return ctx.stopped;
+}
+
+// Не пора ли остановиться: лимит узлов, жёсткий предел времени или
+// остановка из другого потока. Общие счётчики трогаются раз в пачку узлов
+// этого потока (задачи YBWC короткие, поэтому счёт ведётся по потоку).
+static bool shouldStop(SearchContext& ctx) {
+    static thread_local uint64_t pollNodes = 0;
+    SharedSearch& shared = *ctx.shared;
+    if (++pollNodes % TIME_CHECK_NODES == 0) {
+        uint64_t total = shared.nodes.fetch_add(TIME_CHECK_NODES, std::memory_order_relaxed)
+                       + TIME_CHECK_NODES;
+        if ((shared.nodeLimit && total >= shared.nodeLimit)
+            || (shared.hasDeadline && SearchClock::now() >= shared.hardDeadline)) {
+            shared.stop.store(true, std::memory_order_relaxed);
+        }
+    }
+    return checkAborted(ctx);
+}
+
+// Оценка выигрыша в таблице считается от самого узла, а не от корня:
+// одна и та же позиция встречается на разных расстояниях от корня
+static int scoreToTT(int score, int ply) {
+    if (score >= SCORE_WIN - MAX_PLY) return score + ply;
+    if (score <= -(SCORE_WIN - MAX_PLY)) return score - ply;
+    return score;
+}
+
+static int scoreFromTT(int score, int ply) {
+    if (score >= SCORE_WIN - MAX_PLY) return score - ply;
+    if (score <= -(SCORE_WIN - MAX_PLY)) return score + ply;
+    return score;
+}
+
+// Аккумулятор сети после хода m из pos (в storage); nullptr — оценка ручная
+static const NnueAccumulator* childAccumulator(const SearchContext& ctx, const Position& pos,
+                                               const NnueAccumulator* acc, Move m,
+                                               NnueAccumulator& storage)
+{
+    if (!acc) return nullptr;
+    ctx.nnue->update(*acc, pos, m, storage);
+    return &storage;
+}
+
+// Оценка спокойной позиции: сетью по аккумулятору или ручная
+static int evaluateLeaf(const SearchContext& ctx, const Position& pos,
+                        const NnueAccumulator* acc, int color)
+{
+    if (!acc) return evaluate(pos, color);
+    return std::clamp(ctx.nnue->evaluate(*acc, color), -NNUE_SCORE_LIMIT, NNUE_SCORE_LIMIT);
+}
+
+// Переставить ход index в начало списка, порядок остальных сохраняется
+static void moveToFront(MoveList& moves, int index) {
+    Move m = moves.moves[index];
+    for (int i = index; i > 0; --i) {
+        moves.moves[i] = moves.moves[i - 1];
+    }
+    moves.moves[0] = m;
+}
+
+// Таблицы сортировки потока пула: задачи YBWC пишут историю и убийц
+// в таблицы того потока, который их выполняет
+static OrderingTables& threadOrderingTables() {
+    static thread_local std::unique_ptr<OrderingTables> tables = std::make_unique<OrderingTables>();
+    return *tables;
+}
+
+static int negamax(SearchContext& ctx, const Position& pos, const NnueAccumulator* acc,
+                   bool whiteTurn, int depth, int alpha, int beta, int ply, Move prev);
+
+// Занять до wanted свободных потоков пула этого поиска, вернуть сколько заняли
+static int acquireWorkers(SharedSearch& shared, int wanted) {
+    int available = shared.freeWorkers.load(std::memory_order_relaxed);
+    int taken;
+    do {
+        taken = std::min(available, wanted);
+        if (taken <= 0) return 0;
+    } while (!shared.freeWorkers.compare_exchange_weak(available, available - taken,
+                                                       std::memory_order_relaxed));
+    return taken;
+}
+
+// YBWC: старший брат (первый ход) уже просмотрен, ходы начиная с first
+// разбирают по одному сам узел и задачи пула — не больше, чем свободно
+// потоков поиска (пул движка бывает больше, чем просили --threads).
+// Каждый ход ищется с окном по текущему alpha точки разделения; отсечение
+// на одном ходе останавливает остальных. best, bestMove и alpha узла
+// обновляются по итогам всех ходов.
+static void searchYoungerBrothers(SearchContext& ctx, const Position& pos,
+                                  const NnueAccumulator* acc, bool whiteTurn,
+                                  const MoveList& moves, int first, int depth, int& alpha,
+                                  int beta, int ply, int& best, Move& bestMove)
+{
+    SplitPoint sp;
+    sp.parent = ctx.split;
+    sp.alpha.store(alpha, std::memory_order_relaxed);
+    sp.beta = beta;
+    sp.best = best;
+    sp.bestMove = bestMove;
+    sp.next.store(first, std::memory_order_relaxed);
+
+    auto searchMoves = [&](OrderingTables* order) {
+        SearchContext local;
+        local.shared = ctx.shared;
+        local.tt = ctx.tt;
+        local.split = &sp;
+        local.order = order;
+        local.nnue = ctx.nnue;
+        for (int i; (i = sp.next.fetch_add(1, std::memory_order_relaxed)) < moves.size();) {
+            if (checkAborted(local)) break;
+
+            int a = sp.alpha.load(std::memory_order_relaxed);
+            Position next = pos;
+            makeMove(next, moves[i]);
+            NnueAccumulator nextAcc;
+            int score = -negamax(local, next, childAccumulator(local, pos, acc, moves[i], nextAcc),
+                                 !whiteTurn, depth - 1, -beta, -a, ply + 1, moves[i]);
+            if (local.stopped) break;
+
+            std::lock_guard<std::mutex> lock(sp.mutex);
+            if (score > sp.best) {
+                sp.best = score;
+                sp.bestMove = moves[i];
+            }
+            if (score > sp.alpha.load(std::memory_order_relaxed)) {
+                sp.alpha.store(score, std::memory_order_relaxed);
+            }
+            if (score >= beta) sp.cutoff.store(true, std::memory_order_relaxed);
+        }
+        sp.nodes.fetch_add(local.nodes, std::memory_order_relaxed);
+    };
+
+    {
+        // Один ход узел берёт себе, на остальные зовёт свободные потоки
+        SharedSearch& shared = *ctx.shared;
+        int helpers = acquireWorkers(shared, moves.size() - first - 1);
+        TaskGroup group(*shared.pool);
+        for (int k = 0; k < helpers; ++k) {
+            group.run([&]() {
+                searchMoves(&threadOrderingTables());
+                shared.freeWorkers.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        searchMoves(ctx.order);
+        group.wait();
+    }
+
+    ctx.nodes += sp.nodes.load(std::memory_order_relaxed);
+    if (checkAborted(ctx)) return;
+    best = sp.best;
+    bestMove = sp.bestMove;
+    alpha = std::max(alpha, sp.alpha.load(std::memory_order_relaxed));
+}
+
+// Тихий поиск: за горизонтом продолжаются только обязательные взятия.
+// Пока бой обязателен, оценивать позицию нельзя — сторона не может
+// «остаться на месте» и обязана бить; без боя позиция спокойная и
+// оценивается как есть. budget — оставшиеся узлы на этот лист: когда
+// он кончается, позиция оценивается, даже если размен не закончен.
+static int quiescence(SearchContext& ctx, const Position& pos, const NnueAccumulator* acc,
+                      bool whiteTurn, int alpha, int beta, int ply, int& budget)
+{
+    ctx.nodes++;
+    if (shouldStop(ctx)) return 0;
+
+    int color = whiteTurn ? 1 : -1;
+    if (capturingPieces(pos, color) == 0) {
+        if (movablePieces(pos, color) == 0) return -(SCORE_WIN - ply);   // нет ходов — проигрыш
+        return evaluateLeaf(ctx, pos, acc, color);
+    }
+    if (ply >= MAX_PLY || budget <= 0) return evaluateLeaf(ctx, pos, acc, color);
+    budget--;
+
+    // Взятия по убыванию числа побитых: крупный размен скорее даст отсечение
+    MoveList moves;
+    findAllCaptures(pos, whiteTurn, moves, false);
+    std::stable_sort(moves.moves, moves.moves + moves.size(), [](Move a, Move b) {
+        return captureCount(a) > captureCount(b);
+    });
+
+    int best = -SCORE_INFINITY;
+    for (Move m : moves) {
+        Position next = pos;
+        makeMove(next, m);
+        NnueAccumulator nextAcc;
+        int score = -quiescence(ctx, next, childAccumulator(ctx, pos, acc, m, nextAcc),
+                                !whiteTurn, -beta, -alpha, ply + 1, budget);
+        if (ctx.stopped) return 0;
+
+        if (score > best) best = score;
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
+    }
+    return best;
+}
+
+// Негамакс с альфа-бета отсечениями. Оценка — со стороны, которая ходит.
+// acc — аккумулятор сети для pos (nullptr — оценка ручная),
+// prev — ход, которым пришли в узел (для таблицы ответных ходов).
+static int negamax(SearchContext& ctx, const Position& pos, const NnueAccumulator* acc,
+                   bool whiteTurn, int depth, int alpha, int beta, int ply, Move prev)
+{
+    // Горизонт: дальше только тихий поиск по обязательным взятиям
+    if (depth <= 0 || ply >= MAX_PLY) {
+        int budget = QSEARCH_NODE_BUDGET;
+        return quiescence(ctx, pos, acc, whiteTurn, alpha, beta, ply, budget);
+    }
+
+    ctx.nodes++;
+    if (shouldStop(ctx)) return 0;
+
+    // Таблица транспозиций: отсечение по сохранённой оценке или хотя бы ход
+    uint64_t key = positionHash(pos, whiteTurn);
+    TTEntry entry;
+    bool hit = ctx.tt && ctx.tt->probe(key, entry);
+    if (hit && entry.depth >= depth) {
+        int score = scoreFromTT(entry.score, ply);
+        if (entry.bound == Bound::Exact
+            || (entry.bound == Bound::Lower && score >= beta)
+            || (entry.bound == Bound::Upper && score <= alpha)) {
+            return score;
+        }
+    }
+
+    // Взятие обязательно: при бое сортировщик выдаёт только взятия
+    MovePicker picker(pos, whiteTurn, hit ? entry.move : 0, *ctx.order, ply, prev);
+
+    int alphaStart = alpha;
+    int best = -SCORE_INFINITY;
+    Move bestMove{};
+    int moveCount = 0;
+    for (Move m = picker.next(); m != Move{}; m = picker.next()) {
+        if (moveCount == 1 && ctx.shared->pool && depth >= YBWC_MIN_SPLIT_DEPTH) {
+            // Старший брат просмотрен: остальные ходы — задачам пула
+            MoveList rest;
+            for (; m != Move{}; m = picker.next()) rest.push(m);
+            searchYoungerBrothers(ctx, pos, acc, whiteTurn, rest, 0, depth, alpha, beta, ply,
+                                  best, bestMove);
+            if (ctx.stopped) return 0;
+            break;
+        }
+        moveCount++;
+
+        Position next = pos;
+        makeMove(next, m);
+        NnueAccumulator nextAcc;
+        int score = -negamax(ctx, next, childAccumulator(ctx, pos, acc, m, nextAcc),
+                             !whiteTurn, depth - 1, -beta, -alpha, ply + 1, m);
+        if (ctx.stopped) return 0;
+
+        if (score > best) {
+            best = score;
+            bestMove = m;
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
+    }
+    if (moveCount == 0) return -(SCORE_WIN - ply);   // нет ходов — проигрыш
+
+    // Отсечение тихим ходом запоминается в таблицах сортировки
+    if (best >= beta && !picker.capturesOnly()) {
+        ctx.order->updateQuiet(bestMove, whiteTurn, depth, ply, prev);
+    }
+
+    if (ctx.tt) {
+        Bound bound = (best >= beta) ? Bound::Lower
+                    : (best > alphaStart) ? Bound::Exact : Bound::Upper;
+        // При оценке сверху лучший ход ничем не лучше остальных
+        ctx.tt->store(key, bound == Bound::Upper ? Move{} : bestMove,
+                      scoreToTT(best, ply), depth, bound);
+    }
+    return best;
+}
+
+// Одна итерация углубления из корня. Ходы moves перебираются по порядку;
+// лучший переставляется в начало, чтобы следующая итерация начала с него.
+static int searchRoot(SearchContext& ctx, const Position& pos, bool whiteTurn,
+                      MoveList& moves, int depth)
+{
+    // Аккумулятор корня считается с нуля, дальше — только приращения
+    NnueAccumulator rootAcc;
+    const NnueAccumulator* acc = nullptr;
+    if (ctx.nnue) {
+        ctx.nnue->refresh(pos, rootAcc);
+        acc = &rootAcc;
+    }
+
+    int alpha = -SCORE_INFINITY;
+    int bestIndex = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+        Position next = pos;
+        makeMove(next, moves[i]);
+        NnueAccumulator nextAcc;
+        int score = -negamax(ctx, next, childAccumulator(ctx, pos, acc, moves[i], nextAcc),
+                             !whiteTurn, depth - 1, -SCORE_INFINITY, -alpha, 1, moves[i]);
+        if (ctx.stopped) return 0;
+
+        if (score > alpha) {
+            alpha = score;
+            bestIndex = i;
+        }
+    }
+    moveToFront(moves, bestIndex);
+    if (ctx.tt) {
+        ctx.tt->store(positionHash(pos, whiteTurn), moves[0], scoreToTT(alpha, 0), depth, Bound::Exact);
+    }
+    return alpha;
+}
+
+// Итеративное углубление одного потока. Основной поток (main) проверяет
+// мягкий предел и по окончании останавливает остальных; вспомогательные
+// начинают с другой глубины и другого порядка ходов в корне, чтобы не
+// повторять работу основного, и делятся найденным через общую таблицу.
+static void iterativeDeepening(SearchContext& ctx, const Position& pos, bool whiteTurn,
+                               MoveList moves, const SearchLimits& limits,
+                               SearchClock::time_point startTime, int threadIndex,
+                               SearchResult& result)
+{
+    bool main = (threadIndex == 0);
+    int maxDepth = (limits.depth < 1) ? 1 : limits.depth;
+    int firstDepth = 1;
+    if (!main) {
+        std::rotate(moves.moves, moves.moves + threadIndex % moves.size(), moves.moves + moves.size());
+        firstDepth = std::min(maxDepth, 1 + threadIndex % 2);
+    }
+
+    for (int depth = firstDepth; depth <= maxDepth; ++depth) {
+        int score = searchRoot(ctx, pos, whiteTurn, moves, depth);
+        if (ctx.stopped) break;
+
+        result.bestMove = moves[0];
+        result.score = score;
+        result.depth = depth;
+
+        if (!main) continue;
+        // Единственный ход думать дальше не нужно — хватит оценки первой итерации.
+        // Выигрыш или проигрыш найден — глубже ничего не изменится.
+        if (moves.size() == 1 || isWinScore(score)) break;
+        if (limits.softTimeMs > 0
+            && SearchClock::now() - startTime >= std::chrono::milliseconds(limits.softTimeMs)) {
+            break;
+        }
+    }
+}
+
+// Лучший ход стороны whiteTurn: итеративное углубление негамакса
+// с альфа-бета отсечениями. При limits.threads > 1 — параллельный поиск:
+// Lazy SMP (потоки ищут одну и ту же позицию независимо, общая у них
+// только таблица) или YBWC (один поток углубления, узлы делятся между
+// потоками пула после просмотра первого хода).
+SearchResult searchBestMove(const Position& pos, bool whiteTurn, const SearchLimits& limits,
+                            TranspositionTable* tt)
+{
+    auto startTime = SearchClock::now();
+    SearchResult result;
+
+    SharedSearch shared;
+    shared.nodeLimit = limits.nodes;
+    if (tt) tt->newSearch();
+    if (limits.hardTimeMs > 0) {
+        shared.hasDeadline = true;
+        shared.hardDeadline = startTime + std::chrono::milliseconds(limits.hardTimeMs);
+    }
+
+    MoveList moves;
+    generateLegalMoves(pos, whiteTurn, moves);
+    if (moves.empty()) {
+        result.score = -SCORE_WIN;
+        return result;
+    }
+
+    // Ход в любом случае есть, даже если лимит кончится в первой итерации
+    result.bestMove = moves[0];
+    int threadCount = 1;
+    ThreadPool* pool = nullptr;
+    std::unique_ptr<ThreadPool> ownPool;
+    if (limits.threads > 1 && moves.size() > 1
+        && (limits.parallel == ParallelMode::Ybwc || tt))
+    {
+        // Вызывающий поток тоже работает, пулу нужно на один меньше.
+        // Пул движка берётся, если в нём хватает потоков: лишние просто
+        // не получат задач. Свой пул — только если просят больше ядер.
+        unsigned workers = static_cast<unsigned>(limits.threads - 1);
+        pool = &enginePool();
+        if (pool->size() < workers) {
+            ownPool = std::make_unique<ThreadPool>(workers);
+            pool = ownPool.get();
+        }
+        if (limits.parallel == ParallelMode::Ybwc) {
+            shared.pool = pool;
+            shared.freeWorkers.store(static_cast<int>(workers), std::memory_order_relaxed);
+        } else {
+            // Lazy SMP: помощники — задачи пула на всё время поиска.
+            // Без таблицы им нечем делиться, тогда ищет один.
+            threadCount = limits.threads;
+        }
+    }
+
+    std::vector<SearchContext> contexts(threadCount);
+    std::vector<SearchResult> results(threadCount, result);
+    std::vector<std::unique_ptr<OrderingTables>> tables(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        tables[i] = std::make_unique<OrderingTables>();
+        contexts[i].shared = &shared;
+        contexts[i].tt = tt;
+        contexts[i].order = tables[i].get();
+        contexts[i].nnue = limits.nnue;
+    }
+    {
+        // Помощники Lazy SMP ищут в пуле, основной поток — здесь
+        TaskGroup helpers(pool ? *pool : enginePool());
+        for (int i = 1; i < threadCount; ++i) {
+            helpers.run([&, i]() {
+                iterativeDeepening(contexts[i], pos, whiteTurn, moves, limits, startTime, i, results[i]);
+            });
+        }
+        iterativeDeepening(contexts[0], pos, whiteTurn, moves, limits, startTime, 0, results[0]);
+        shared.stop.store(true, std::memory_order_relaxed);
+        helpers.wait();
+    }
+
+    // Ход основного потока, если никто не закончил итерацию глубже
+    result = results[0];
+    for (int i = 1; i < threadCount; ++i) {
+        if (results[i].depth > result.depth) result = results[i];
+    }
+    result.nodes = 0;
+    for (const auto& ctx : contexts) {
+        result.nodes += ctx.nodes;
+    }
+    return result;
+}
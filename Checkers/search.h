@@ -0,0 +1,56 @@
+#pragma once
+
+#include "board.h"
+#include "tt.h"
+
+#include <cstdint>
+
+class NnueNetwork;
+
+// -------------------- Поиск --------------------
+// Оценки в единицах простой шашки = 100. Выигрыш на расстоянии ply полуходов
+// от корня оценивается как SCORE_WIN - ply: ближний выигрыш лучше дальнего.
+// Все оценки помещаются в int16 записи таблицы транспозиций.
+static constexpr int SCORE_WIN = 30000;
+static constexpr int SCORE_INFINITY = SCORE_WIN + 1;
+static constexpr int MAX_PLY = 128;
+
+// Выигрыш (или проигрыш) найден в пределах MAX_PLY
+constexpr bool isWinScore(int score) {
+    return score >= SCORE_WIN - MAX_PLY || score <= -(SCORE_WIN - MAX_PLY);
+}
+
+// Режим параллельного поиска
+enum class ParallelMode {
+    LazySmp,    // независимые потоки с общей таблицей транспозиций
+    Ybwc,       // Young Brothers Wait: младшие ходы узла — задачи пула с кражей работы
+};
+
+// Ограничения поиска: глубина в полуходах, число узлов и время (0 — без ограничения).
+// Мягкий предел: новая итерация углубления после него не начинается.
+// Жёсткий: текущая итерация прерывается, ход берётся из последней законченной.
+// threads — число потоков, parallel — как они делят работу
+// (Lazy SMP без таблицы транспозиций работает в один поток).
+// nnue — оценка нейросетью вместо ручной (сеть живёт дольше поиска).
+struct SearchLimits {
+    int depth = 8;
+    uint64_t nodes = 0;
+    int64_t softTimeMs = 0;
+    int64_t hardTimeMs = 0;
+    int threads = 1;
+    ParallelMode parallel = ParallelMode::LazySmp;
+    const NnueNetwork* nnue = nullptr;
+};
+
+struct SearchResult {
+    Move bestMove{};       // Move{} — ходов нет
+    int score = 0;         // со стороны, которая ходит
+    int depth = 0;         // последняя законченная итерация (0 — не закончена ни одна)
+    uint64_t nodes = 0;
+};
+
+// Лучший ход стороны whiteTurn: итеративное углубление негамакса
+// с альфа-бета отсечениями. tt — таблица транспозиций (nullptr — без неё),
+// между ходами партии её стоит сохранять.
+SearchResult searchBestMove(const Position& pos, bool whiteTurn, const SearchLimits& limits,
+                            TranspositionTable* tt = nullptr);
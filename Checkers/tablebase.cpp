@@ -0,0 +1,469 @@
+#include "tablebase.h"
+#include "movegen.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// -------------------- Сочетания --------------------
+struct BinomialTable {
+    uint64_t c[SQUARE_COUNT + 1][SQUARE_COUNT + 1];
+};
+
+constexpr BinomialTable buildBinomials() {
+    BinomialTable t{};
+    for (int n = 0; n <= SQUARE_COUNT; ++n) {
+        t.c[n][0] = 1;
+        for (int k = 1; k <= n; ++k) {
+            t.c[n][k] = t.c[n - 1][k - 1] + (k < n ? t.c[n - 1][k] : 0);
+        }
+    }
+    return t;
+}
+
+static constexpr BinomialTable BINOMIAL = buildBinomials();
+
+// C(n, k), 0 при k > n
+static uint64_t binomial(int n, int k) {
+    return (n < 0 || k < 0) ? 0 : BINOMIAL.c[n][k];
+}
+
+// Номер поля, n-го по счёту среди полей маски
+static int nthSquare(uint32_t mask, int n) {
+    for (; n > 0; --n) mask &= mask - 1;
+    return std::countr_zero(mask);
+}
+
+// Номер подмножества squares среди подмножеств allowed той же мощности
+// (колексикографический: сумма C(p_i, i) по местам полей внутри allowed)
+static uint64_t rankSubset(uint32_t squares, uint32_t allowed) {
+    uint64_t rank = 0;
+    int i = 0;
+    for (; squares; squares &= squares - 1) {
+        int sq = std::countr_zero(squares);
+        rank += BINOMIAL.c[std::popcount(allowed & ((1u << sq) - 1))][++i];
+    }
+    return rank;
+}
+
+static uint32_t unrankSubset(uint64_t rank, int count, uint32_t allowed) {
+    uint32_t result = 0;
+    int p = std::popcount(allowed) - 1;
+    for (int i = count; i >= 1; --i, --p) {
+        while (BINOMIAL.c[p][i] > rank) --p;
+        rank -= BINOMIAL.c[p][i];
+        result |= 1u << nthSquare(allowed, p);
+    }
+    return result;
+}
+
+// -------------------- Индекс среза --------------------
+// Белые шашки не стоят на строке 0, чёрные — на строке 7. Белые шашки
+// делятся на стоящие на строке 7 (туда чёрным шашкам нельзя) и на
+// средних строках: от их числа зависит, сколько полей остаётся чёрным.
+static constexpr uint32_t WHITE_BACK_ROW = promotionRow(-1);
+static constexpr uint32_t MIDDLE_ROWS = ~(promotionRow(1) | promotionRow(-1));
+static constexpr uint32_t BLACK_MEN_SQUARES = ~promotionRow(-1);
+static constexpr int ROW_SQUARES = BOARD_SIZE / 2;
+static constexpr int MIDDLE_SQUARES = SQUARE_COUNT - 2 * ROW_SQUARES;
+static constexpr int MEN_SQUARES = SQUARE_COUNT - ROW_SQUARES;
+
+Material materialOf(const Position& pos) {
+    Material m;
+    m.ownMen = std::popcount(pos.white & ~pos.kings);
+    m.ownKings = std::popcount(pos.white & pos.kings);
+    m.foeMen = std::popcount(pos.black & ~pos.kings);
+    m.foeKings = std::popcount(pos.black & pos.kings);
+    return m;
+}
+
+SliceIndex::SliceIndex(const Material& material) : material(material) {
+    int men = material.ownMen + material.foeMen;
+    uint64_t kings = binomial(SQUARE_COUNT - men, material.ownKings)
+                   * binomial(SQUARE_COUNT - men - material.ownKings, material.foeKings);
+    for (int k = 0; k <= ROW_SQUARES; ++k) {
+        blockOffset[k] = total;
+        int middle = material.ownMen - k;
+        if (middle < 0 || middle > MIDDLE_SQUARES) continue;
+        total += binomial(ROW_SQUARES, k) * binomial(MIDDLE_SQUARES, middle)
+               * binomial(MEN_SQUARES - middle, material.foeMen) * kings;
+    }
+}
+
+uint64_t SliceIndex::index(const Position& pos) const {
+    uint32_t whiteMen = pos.white & ~pos.kings;
+    uint32_t blackMen = pos.black & ~pos.kings;
+    uint32_t whiteKings = pos.white & pos.kings;
+    uint32_t blackKings = pos.black & pos.kings;
+
+    uint32_t back = whiteMen & WHITE_BACK_ROW;
+    int k = std::popcount(back);
+    int middle = material.ownMen - k;
+    int freeCount = SQUARE_COUNT - material.ownMen - material.foeMen;
+    uint32_t free = ~(whiteMen | blackMen);
+
+    uint64_t r = rankSubset(back, WHITE_BACK_ROW) * binomial(MIDDLE_SQUARES, middle)
+               + rankSubset(whiteMen & MIDDLE_ROWS, MIDDLE_ROWS);
+    r = r * binomial(MEN_SQUARES - middle, material.foeMen)
+      + rankSubset(blackMen, BLACK_MEN_SQUARES & ~whiteMen);
+    r = r * binomial(freeCount, material.ownKings) + rankSubset(whiteKings, free);
+    r = r * binomial(freeCount - material.ownKings, material.foeKings)
+      + rankSubset(blackKings, free & ~whiteKings);
+    return blockOffset[k] + r;
+}
+
+Position SliceIndex::position(uint64_t index) const {
+    // Блок, в который попадает номер (пустые блоки пропускаются)
+    int k = 0;
+    while (k < ROW_SQUARES && index >= blockOffset[k + 1]) ++k;
+    uint64_t r = index - blockOffset[k];
+    int middle = material.ownMen - k;
+    int freeCount = SQUARE_COUNT - material.ownMen - material.foeMen;
+
+    uint64_t blackKingsSize = binomial(freeCount - material.ownKings, material.foeKings);
+    uint64_t blackKingsRank = r % blackKingsSize;
+    r /= blackKingsSize;
+    uint64_t whiteKingsSize = binomial(freeCount, material.ownKings);
+    uint64_t whiteKingsRank = r % whiteKingsSize;
+    r /= whiteKingsSize;
+    uint64_t blackMenSize = binomial(MEN_SQUARES - middle, material.foeMen);
+    uint64_t blackMenRank = r % blackMenSize;
+    r /= blackMenSize;
+    uint64_t middleSize = binomial(MIDDLE_SQUARES, middle);
+
+    uint32_t whiteMen = unrankSubset(r / middleSize, k, WHITE_BACK_ROW)
+                      | unrankSubset(r % middleSize, middle, MIDDLE_ROWS);
+    uint32_t blackMen = unrankSubset(blackMenRank, material.foeMen, BLACK_MEN_SQUARES & ~whiteMen);
+    uint32_t free = ~(whiteMen | blackMen);
+    uint32_t whiteKings = unrankSubset(whiteKingsRank, material.ownKings, free);
+    uint32_t blackKings = unrankSubset(blackKingsRank, material.foeKings, free & ~whiteKings);
+
+    Position pos;
+    pos.white = whiteMen | whiteKings;
+    pos.black = blackMen | blackKings;
+    pos.kings = whiteKings | blackKings;
+    recomputeDerived(pos);
+    return pos;
+}
+
+// -------------------- Ретроградный анализ --------------------
+// Решённые и решаемые срезы, по коду материала
+struct Slice;
+
+// Рабочее состояние позиций среза, пока решается его группа
+struct SliceWork {
+    // Тихих ходов внутри группы, ещё не ведущих в выигрыш соперника
+    std::unique_ptr<std::atomic<uint8_t>[]> remaining;
+    // Ходы из группы (взятия и превращения) ведут в решённые срезы:
+    // 1 + кратчайший проигрыш соперника (0 — такого хода нет) и
+    // 1 + самый долгий выигрыш соперника
+    std::unique_ptr<uint16_t[]> exitWin;
+    std::unique_ptr<uint16_t[]> exitLoss;
+    // Позиция может оказаться проигранной: нет выхода в ничью или в проигрыш соперника
+    std::unique_ptr<bool[]> canLose;
+    Slice* mirror = nullptr;    // срез соперника: тихие ходы ведут туда и оттуда
+
+    explicit SliceWork(uint64_t size)
+        : remaining(std::make_unique<std::atomic<uint8_t>[]>(size)),
+          exitWin(std::make_unique<uint16_t[]>(size)),
+          exitLoss(std::make_unique<uint16_t[]>(size)),
+          canLose(std::make_unique<bool[]>(size)) {}
+};
+
+struct Slice {
+    Material material;
+    SliceIndex index;
+    std::unique_ptr<std::atomic<uint16_t>[]> values;
+    std::unique_ptr<SliceWork> work;
+
+    explicit Slice(const Material& m)
+        : material(m), index(m), values(std::make_unique<std::atomic<uint16_t>[]>(index.size())) {}
+};
+
+static constexpr int MATERIAL_CODES = 13 * 13 * 13 * 13;   // до 12 фигур каждого вида
+
+static int materialCode(const Material& m) {
+    return ((m.ownMen * 13 + m.ownKings) * 13 + m.foeMen) * 13 + m.foeKings;
+}
+
+using SliceTable = std::vector<std::unique_ptr<Slice>>;
+
+// Позиции решаются кусками по столько штук на задачу пула
+static constexpr uint64_t TB_CHUNK = 1 << 14;
+
+// Поворот доски на 180 градусов с заменой цветов: ход снова у белых.
+// Поле sq переходит в 31 - sq — это разворот битов.
+static uint32_t reverseSquares(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+static Position flipped(const Position& pos) {
+    Position q;
+    q.white = reverseSquares(pos.black);
+    q.black = reverseSquares(pos.white);
+    q.kings = reverseSquares(pos.kings);
+    return q;
+}
+
+// Значение позиции после хода (ход у соперника, уже повёрнута к белым)
+static uint16_t successorValue(const SliceTable& slices, const Position& pos) {
+    if (pos.white == 0) return TB_LOSS;     // фигур не осталось — ходов нет
+    const Slice& slice = *slices[materialCode(materialOf(pos))];
+    return slice.values[slice.index.index(pos)].load(std::memory_order_relaxed);
+}
+
+// Ход остаётся в группе срезов: тихий и без превращения
+static bool staysInGroup(Move m) {
+    return moveCaptured(m) == 0 && !movePromotes(m);
+}
+
+// Записать значение, если позиция ещё не решена; true — записано
+static bool resolve(Slice& slice, uint64_t i, uint16_t value) {
+    uint16_t expected = 0;
+    return slice.values[i].compare_exchange_strong(expected, value, std::memory_order_relaxed);
+}
+
+// Подготовка позиции: ходы из группы ведут в решённые срезы и сразу дают
+// всё, что о них нужно; тихие ходы внутри группы только считаются.
+// Позиция без ходов — проигрыш на месте. Возвращает самое дальнее
+// расстояние, на котором позицию решат выходы из группы.
+static int setupPosition(const SliceTable& slices, Slice& slice, uint64_t i) {
+    Position pos = slice.index.position(i);
+    MoveList moves;
+    generateLegalMoves(pos, true, moves, false);
+    if (moves.empty()) {
+        slice.values[i].store(TB_LOSS, std::memory_order_relaxed);
+        return 0;
+    }
+
+    int inGroup = 0;
+    int win = 0, loss = 0;
+    bool draw = false;
+    for (Move m : moves) {
+        if (staysInGroup(m)) {
+            inGroup++;
+            continue;
+        }
+        Position next = pos;
+        makeMove(next, m);
+        uint16_t v = successorValue(slices, flipped(next));
+        int distance = (v & TB_DISTANCE_MASK) + 1;
+        if (v & TB_LOSS) {
+            win = (win == 0) ? distance : std::min(win, distance);
+        } else if (v & TB_WIN) {
+            loss = std::max(loss, distance);
+        } else {
+            draw = true;
+        }
+    }
+
+    SliceWork& work = *slice.work;
+    work.remaining[i].store(static_cast<uint8_t>(inGroup), std::memory_order_relaxed);
+    work.exitWin[i] = static_cast<uint16_t>(win);
+    work.exitLoss[i] = static_cast<uint16_t>(loss);
+    work.canLose[i] = !draw && win == 0;
+    return std::max(win, loss);
+}
+
+// Позиция i среза решена на уровне level - 1: её предшественники внутри
+// группы — позиции соперника до его тихого хода (ход назад). Ход назад
+// допустим, только если у соперника не было взятия. Проигрыш здесь —
+// выигрыш на уровне level у предшественника; выигрыш — у предшественника
+// на один ход «в выигрыш соперника» больше, и когда таких не остаётся,
+// он проигран. Возвращает true, если решена хоть одна позиция.
+static bool expandPosition(Slice& slice, uint64_t i, uint16_t value, int level) {
+    Position pos = slice.index.position(i);
+    Slice& mirror = *slice.work->mirror;
+    SliceWork& mirrorWork = *mirror.work;
+    bool lost = (value & TB_LOSS) != 0;
+    uint32_t empty = ~occupied(pos);
+    bool any = false;
+
+    for (uint32_t pieces = pos.black; pieces; pieces &= pieces - 1) {
+        int to = std::countr_zero(pieces);
+        bool king = (pos.kings >> to) & 1;
+        // Шашка чёрных идёт к строке 7 — пришла с соседнего поля выше;
+        // дамка — с любого свободного поля любого луча
+        for (int d = king ? 0 : 2; d < 4; ++d) {
+            int length = king ? DIAG.rayLength[to][d] : std::min<int>(1, DIAG.rayLength[to][d]);
+            for (int step = 0; step < length; ++step) {
+                int from = DIAG.ray[to][d][step];
+                if (!(empty & (1u << from))) break;
+
+                Position before = pos;
+                before.black = (before.black & ~(1u << to)) | (1u << from);
+                if (king) before.kings = (before.kings & ~(1u << to)) | (1u << from);
+                if (capturingPieces(before, -1) != 0) continue;   // был обязательный бой
+
+                uint64_t j = mirror.index.index(flipped(before));
+                if (lost) {
+                    any |= resolve(mirror, j, static_cast<uint16_t>(TB_WIN | level));
+                } else if (mirrorWork.remaining[j].fetch_sub(1, std::memory_order_relaxed) == 1
+                           && mirrorWork.canLose[j] && mirrorWork.exitLoss[j] <= level) {
+                    any |= resolve(mirror, j, static_cast<uint16_t>(TB_LOSS | level));
+                }
+            }
+        }
+    }
+    return any;
+}
+
+// Все позиции группы кусками по TB_CHUNK задачами пула
+template <class ChunkFn>
+static void forEachChunk(const std::vector<Slice*>& group, ChunkFn fn) {
+    TaskGroup tasks(enginePool());
+    for (Slice* slice : group) {
+        for (uint64_t start = 0; start < slice->index.size(); start += TB_CHUNK) {
+            uint64_t end = std::min(slice->index.size(), start + TB_CHUNK);
+            tasks.run([&fn, slice, start, end]() { fn(*slice, start, end); });
+        }
+    }
+    tasks.wait();
+}
+
+// Решить группу срезов. Уровень level — позиции с расстоянием level:
+// раскрываются решённые на прошлом уровне, и решаются те, кого выходы
+// из группы решают именно на этом.
+static void solveGroup(const SliceTable& slices, const std::vector<Slice*>& group) {
+    for (Slice* slice : group) {
+        slice->work = std::make_unique<SliceWork>(slice->index.size());
+    }
+    for (Slice* slice : group) {
+        const Material& m = slice->material;
+        Material mirror{m.foeMen, m.foeKings, m.ownMen, m.ownKings};
+        slice->work->mirror = slices[materialCode(mirror)].get();
+    }
+
+    std::atomic<int> lastScheduled{0};
+    forEachChunk(group, [&](Slice& slice, uint64_t start, uint64_t end) {
+        int local = 0;
+        for (uint64_t i = start; i < end; ++i) {
+            local = std::max(local, setupPosition(slices, slice, i));
+        }
+        int seen = lastScheduled.load(std::memory_order_relaxed);
+        while (local > seen && !lastScheduled.compare_exchange_weak(seen, local)) {}
+    });
+
+    for (int level = 1;; ++level) {
+        std::atomic<bool> changed{false};
+        forEachChunk(group, [&](Slice& slice, uint64_t start, uint64_t end) {
+            const SliceWork& work = *slice.work;
+            bool any = false;
+            for (uint64_t i = start; i < end; ++i) {
+                uint16_t v = slice.values[i].load(std::memory_order_relaxed);
+                if (v != 0) {
+                    if ((v & TB_DISTANCE_MASK) == level - 1) any |= expandPosition(slice, i, v, level);
+                } else if (work.exitWin[i] == level) {
+                    any |= resolve(slice, i, static_cast<uint16_t>(TB_WIN | level));
+                } else if (work.canLose[i] && work.exitLoss[i] == level
+                           && work.remaining[i].load(std::memory_order_relaxed) == 0) {
+                    any |= resolve(slice, i, static_cast<uint16_t>(TB_LOSS | level));
+                }
+            }
+            if (any) changed.store(true, std::memory_order_relaxed);
+        });
+        if (!changed.load() && level >= lastScheduled.load()) break;
+    }
+
+    for (Slice* slice : group) slice->work.reset();
+}
+
+static std::string materialName(const Material& m) {
+    return std::format("{}{}{}{}", m.ownMen, m.ownKings, m.foeMen, m.foeKings);
+}
+
+// Записать срез в outDir; false — ошибка записи
+static bool writeSlice(const Slice& slice, const TablebaseOptions& options) {
+    auto path = std::filesystem::path(options.outDir)
+              / (materialName(slice.material) + (options.dtw ? ".dtw" : ".wld"));
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    uint64_t size = slice.index.size();
+    if (options.dtw) {
+        std::vector<uint16_t> data(size);
+        for (uint64_t i = 0; i < size; ++i) data[i] = slice.values[i].load(std::memory_order_relaxed);
+        out.write(reinterpret_cast<const char*>(data.data()),
+                  static_cast<std::streamsize>(data.size() * sizeof(uint16_t)));
+    } else {
+        std::vector<uint8_t> data((size + 3) / 4, 0);
+        for (uint64_t i = 0; i < size; ++i) {
+            uint16_t v = slice.values[i].load(std::memory_order_relaxed);
+            uint8_t wld = (v & TB_WIN) ? 1 : (v & TB_LOSS) ? 2 : 0;
+            data[i / 4] |= static_cast<uint8_t>(wld << (2 * (i % 4)));
+        }
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+// Срезы решаются группами: одинаковое число фигур и шашек. Взятие уводит
+// в срез с меньшим числом фигур, превращение — с меньшим числом шашек;
+// тихий ход без превращения оставляет в той же группе (срез соперника).
+int runTablebaseGeneration(const TablebaseOptions& options) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::error_code error;
+    std::filesystem::create_directories(options.outDir, error);
+    if (error) {
+        std::cerr << std::format("Не удалось создать каталог {}: {}\n", options.outDir, error.message());
+        return 1;
+    }
+
+    SliceTable slices(MATERIAL_CODES);
+    uint64_t totalPositions = 0;
+
+    for (int pieces = 2; pieces <= options.maxPieces; ++pieces) {
+        for (int men = 0; men <= pieces; ++men) {
+            std::vector<Slice*> group;
+            for (int ownMen = 0; ownMen <= men; ++ownMen) {
+                for (int ownKings = 0; ownKings <= pieces - men; ++ownKings) {
+                    Material m{ownMen, ownKings, men - ownMen, pieces - men - ownKings};
+                    if (m.ownMen + m.ownKings == 0 || m.foeMen + m.foeKings == 0) continue;
+                    slices[materialCode(m)] = std::make_unique<Slice>(m);
+                    group.push_back(slices[materialCode(m)].get());
+                }
+            }
+            if (group.empty()) continue;
+
+            solveGroup(slices, group);
+
+            for (Slice* slice : group) {
+                uint64_t wins = 0, losses = 0, longest = 0;
+                uint64_t size = slice->index.size();
+                for (uint64_t i = 0; i < size; ++i) {
+                    uint16_t v = slice->values[i].load(std::memory_order_relaxed);
+                    if (v & TB_WIN) wins++;
+                    if (v & TB_LOSS) losses++;
+                    longest = std::max<uint64_t>(longest, v & TB_DISTANCE_MASK);
+                }
+                totalPositions += size;
+                std::cout << std::format("{}: позиций {}, выигрыш {}, проигрыш {}, ничья {}, "
+                                         "самый долгий результат {} полуходов\n",
+                                         materialName(slice->material), size, wins, losses,
+                                         size - wins - losses, longest);
+                if (!writeSlice(*slice, options)) {
+                    std::cerr << std::format("Не удалось записать срез {}\n", materialName(slice->material));
+                    return 1;
+                }
+            }
+        }
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+    std::cout << std::format("Всего позиций: {}\n", totalPositions);
+    std::cout << std::format("Потоков: {}\n", enginePool().size());
+    std::cout << std::format("Время: {} ms\n", elapsed);
+    return 0;
+}
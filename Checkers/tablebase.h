@@ -0,0 +1,66 @@
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+#include <string>
+
+// -------------------- Эндшпильные базы --------------------
+// Базы строятся ретроградным анализом по срезам материала. Сторона хода
+// всегда приводится к белым (доска поворачивается, цвета меняются), так что
+// срез задаётся числом шашек и дамок стороны хода и соперника.
+//
+// Результат позиции — со стороны хода: выигрыш или проигрыш за столько-то
+// полуходов до позиции, где у проигравшего нет ходов, либо ничья.
+
+// Материал среза. Код среза — четыре цифры в этом порядке, например 2101.
+struct Material {
+    int ownMen = 0, ownKings = 0;
+    int foeMen = 0, foeKings = 0;
+
+    int total() const { return ownMen + ownKings + foeMen + foeKings; }
+};
+
+// Материал позиции с ходом белых
+Material materialOf(const Position& pos);
+
+// Совершенный индекс позиций среза (ход белых): номер 0..size()-1 взаимно
+// однозначно соответствует расстановке. Шашки не стоят на поле своего
+// превращения; дамки — на любом свободном поле.
+class SliceIndex {
+public:
+    explicit SliceIndex(const Material& material);
+
+    uint64_t size() const { return total; }
+    uint64_t index(const Position& pos) const;
+    Position position(uint64_t index) const;
+
+private:
+    // Раскладка: блок по числу белых шашек на последней строке (k), внутри
+    // блока — белые шашки, чёрные шашки среди оставшихся разрешённых полей,
+    // белые дамки и чёрные дамки среди свободных
+    Material material;
+    uint64_t blockOffset[5] = {};
+    uint64_t total = 0;
+};
+
+// Значение позиции в базе: 0 — ничья (или ещё не решено),
+// TB_WIN | d / TB_LOSS | d — выигрыш / проигрыш за d полуходов
+static constexpr uint16_t TB_WIN = 0x4000;
+static constexpr uint16_t TB_LOSS = 0x8000;
+static constexpr uint16_t TB_DISTANCE_MASK = 0x3FFF;
+// Все решённые срезы держатся в памяти (2 байта на позицию) плюс 6 байт на
+// позицию решаемой группы: 5 фигур — около 0.6 ГБ, 6 — около 10 ГБ,
+// 7 — уже больше 130 ГБ. Поэтому не больше шести.
+static constexpr int MAX_TABLEBASE_PIECES = 6;
+
+struct TablebaseOptions {
+    int maxPieces = 4;
+    bool dtw = false;               // сохранять расстояние до выигрыша, а не только W/L/D
+    std::string outDir = "tb";
+};
+
+// Построить базы всех срезов до maxPieces фигур и записать их в outDir:
+// <код>.wld — по 2 бита на позицию (0 ничья, 1 выигрыш, 2 проигрыш),
+// <код>.dtw — по uint16 на позицию (значение как выше). Код возврата для main.
+int runTablebaseGeneration(const TablebaseOptions& options);
@@ -0,0 +1,11 @@
+#include "thread_pool.h"
+
+// Пул движка: создаётся при первом обращении и живёт до конца программы
+ThreadPool& enginePool() {
+    static ThreadPool pool([]() {
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 2u : hw;
+    }());
+    return pool;
+}
+
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// -------------------- Пул потоков --------------------
+// Долгоживущий пул с очередью на каждый поток и кражей задач.
+// Задача, поставленная из потока пула, идёт в его собственную очередь
+// (берётся с хвоста), свободные потоки крадут из чужих очередей с головы.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount) {
+        if (threadCount == 0) threadCount = 1;
+        for (unsigned i = 0; i < threadCount; ++i) {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this, i]() { workerLoop(static_cast<int>(i)); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const {
+        return static_cast<unsigned>(threads.size());
+    }
+
+    void submit(std::function<void()> task) {
+        int idx = currentWorker;
+        if (currentOwner != this || idx < 0) {
+            idx = static_cast<int>(nextQueue++ % queues.size());
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[idx]->mutex);
+            queues[idx]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            ++queued;
+        }
+        wake.notify_one();
+    }
+
+    // Выполнить одну задачу из очередей пула, если она есть
+    bool runPendingTask() {
+        std::function<void()> task;
+        if (!takeTask(currentOwner == this ? currentWorker : -1, task)) return false;
+        task();
+        return true;
+    }
+
+    // Помогать пулу, пока done() не вернёт true (не блокирует поток пула)
+    template <class Pred>
+    void helpUntil(Pred done) {
+        while (!done()) {
+            if (!runPendingTask()) std::this_thread::yield();
+        }
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool takeTask(int self, std::function<void()>& task) {
+        if (queued.load(std::memory_order_acquire) == 0) return false;
+        int n = static_cast<int>(queues.size());
+        // Сначала своя очередь с хвоста, затем кража у остальных с головы
+        if (self >= 0) {
+            std::lock_guard<std::mutex> lock(queues[self]->mutex);
+            if (!queues[self]->tasks.empty()) {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+                --queued;
+                return true;
+            }
+        }
+        int start = (self >= 0) ? self + 1 : 0;
+        for (int k = 0; k < n; ++k) {
+            int victim = (start + k) % n;
+            if (victim == self) continue;
+            std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+            if (!queues[victim]->tasks.empty()) {
+                task = std::move(queues[victim]->tasks.front());
+                queues[victim]->tasks.pop_front();
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int index) {
+        currentOwner = this;
+        currentWorker = index;
+        while (true) {
+            std::function<void()> task;
+            if (takeTask(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{0};
+    std::atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+
+    static inline thread_local ThreadPool* currentOwner = nullptr;
+    static inline thread_local int currentWorker = -1;
+};
+
+// Группа задач: run() отдаёт задачу пулу, wait() помогает пулу до завершения всех
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() { wait(); }
+
+    void run(std::function<void()> task) {
+        ++pending;
+        pool.submit([this, task = std::move(task)]() {
+            task();
+            --pending;
+        });
+    }
+
+    void wait() {
+        pool.helpUntil([this]() { return pending.load() == 0; });
+    }
+
+private:
+    ThreadPool& pool;
+    std::atomic<int> pending{0};
+};
+
+// Пул движка: создаётся при первом обращении и живёт до конца программы
+ThreadPool& enginePool();
@@ -0,0 +1,76 @@
+#include "tt.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    bucketCount = hashTableCount(megabytes, sizeof(Bucket));
+    buckets = std::make_unique<Bucket[]>(bucketCount);
+}
+
+// Очистить таблицу (новая партия)
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (Slot &s : buckets[i].slots) s.clear();
+    }
+    generation = 0;
+}
+
+uint64_t TranspositionTable::pack(uint32_t move, int score, int depth, Bound bound, uint32_t gen) {
+    return static_cast<uint64_t>(move & 0x7FFFFFF)
+         | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 27)
+         | (static_cast<uint64_t>(bound) << 43)
+         | (static_cast<uint64_t>(depth & 0x7F) << 45)
+         | (static_cast<uint64_t>(gen & GENERATION_MASK) << 52);
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+    TTEntry e;
+    e.move = static_cast<uint32_t>(data & 0x7FFFFFF);
+    e.score = static_cast<int16_t>((data >> 27) & 0xFFFF);
+    e.bound = static_cast<Bound>((data >> 43) & 3);
+    e.depth = dataDepth(data);
+    return e;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) const {
+    const Bucket &b = buckets[key & (bucketCount - 1)];
+    for (const Slot &s : b.slots) {
+        uint64_t data;
+        if (s.load(key, data)) {
+            entry = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound) {
+    Bucket &b = buckets[key & (bucketCount - 1)];
+    uint32_t packedMove = (move == Move{}) ? 0 : compactMove(move);
+
+    // Та же позиция уже есть: обновляем на месте, лучший ход без нового не теряем
+    Slot *target = nullptr;
+    for (Slot &s : b.slots) {
+        uint64_t data;
+        if (s.load(key, data)) {
+            if (packedMove == 0) packedMove = unpack(data).move;
+            target = &s;
+            break;
+        }
+    }
+
+    // Иначе — самая мелкая и старая из замещаемых по глубине; если она
+    // ценнее новой записи, новая идёт в слот постоянной замены
+    if (!target) {
+        int worstValue = 0;
+        for (int i = 0; i < BUCKET_SIZE - 1; ++i) {
+            uint64_t data = b.slots[i].data.load(std::memory_order_relaxed);
+            int value = (data == 0) ? -1000 : dataDepth(data) - 8 * static_cast<int>(age(data));
+            if (!target || value < worstValue) {
+                target = &b.slots[i];
+                worstValue = value;
+            }
+        }
+        if (worstValue > depth) target = &b.slots[BUCKET_SIZE - 1];
+    }
+
+    target->store(key, pack(packedMove, score, depth, bound, generation));
+}
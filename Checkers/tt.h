@@ -0,0 +1,78 @@
+#pragma once
+
+#include "board.h"
+#include "hash_table.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// -------------------- Таблица транспозиций --------------------
+// Общая для всех потоков поиска, слоты без блокировок (см. LocklessSlot).
+// Корзина — 4 записи в одной строке кэша: первые три заменяются по
+// глубине (с поправкой на возраст), последняя — всегда.
+
+// Тип оценки в записи
+enum class Bound : uint8_t {
+    None = 0,
+    Upper = 1,      // оценка не больше сохранённой (все ходы хуже alpha)
+    Lower = 2,      // оценка не меньше сохранённой (отсечение по beta)
+    Exact = 3,
+};
+
+// Ход в записи сжат до 27 бит: поля, превращение и свёртка маски побитых.
+// Полный ход восстанавливается сравнением со списком легальных ходов.
+inline uint32_t compactMove(Move m) {
+    uint32_t captured = moveCaptured(m);
+    return static_cast<uint32_t>(m.bits & 0x7FF) | (((captured ^ (captured >> 16)) & 0xFFFF) << 11);
+}
+
+struct TTEntry {
+    uint32_t move = 0;      // compactMove, 0 — хода нет
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+};
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes);
+
+    // Очистить таблицу (новая партия)
+    void clear();
+    // Новый поиск: записи прошлых поисков становятся старше
+    void newSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+    bool probe(uint64_t key, TTEntry &entry) const;
+    void store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+    size_t sizeMb() const { return bucketCount * sizeof(Bucket) / (1024 * 1024); }
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+    static constexpr uint32_t GENERATION_MASK = 0x3F;
+
+    using Slot = LocklessSlot;
+
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    // Раскладка data:
+    //   биты 0..26  — compactMove
+    //   биты 27..42 — оценка (int16)
+    //   биты 43..44 — Bound
+    //   биты 45..51 — глубина
+    //   биты 52..57 — поколение
+    static uint64_t pack(uint32_t move, int score, int depth, Bound bound, uint32_t gen);
+    static TTEntry unpack(uint64_t data);
+    static uint32_t dataGeneration(uint64_t data) { return (data >> 52) & GENERATION_MASK; }
+    static int dataDepth(uint64_t data) { return static_cast<int>((data >> 45) & 0x7F); }
+
+    // Возраст записи в поисках: 0 — записана в текущем
+    uint32_t age(uint64_t data) const { return (generation - dataGeneration(data)) & GENERATION_MASK; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint32_t generation = 0;
+};